@@ -9,6 +9,8 @@ using std::pair;
 using std::vector;
 using std::ostream;
 using std::max;
+using std::find;
+using std::lower_bound;
 
 
 
@@ -379,8 +381,9 @@ class DiGraph {
  * @tparam V vertex value type (vertex data)
  * @tparam E edge value type (edge weight)
  * @tparam O offset type
+ * @tparam S storage type (vector, or MappedVector for uninitialized, first-touch allocation)
  */
-template <class K=uint32_t, class V=None, class E=None, class O=size_t>
+template <class K=uint32_t, class V=None, class E=None, class O=size_t, tclass1 S=vector>
 class DiGraphCsr {
   #pragma region TYPES
   public:
@@ -398,15 +401,17 @@ class DiGraphCsr {
   #pragma region DATA
   public:
   /** Offsets of the outgoing edges of vertices. */
-  vector<O> offsets;
+  S<O> offsets;
   /** Degree of each vertex. */
-  vector<K> degrees;
+  S<K> degrees;
   /** Vertex values. */
-  vector<V> values;
+  S<V> values;
   /** Vertex ids of the outgoing edges of each vertex (lookup using offsets). */
-  vector<K> edgeKeys;
+  S<K> edgeKeys;
   /** Edge weights of the outgoing edges of each vertex (lookup using offsets). */
-  vector<E> edgeValues;
+  S<E> edgeValues;
+  /** Are the outgoing edges of each vertex sorted by target vertex id? */
+  bool sorted = false;
   #pragma endregion
 
 
@@ -512,7 +517,7 @@ class DiGraphCsr {
   #pragma region OFFSET
   public:
   /**
-   * Get the offset of an edge in the graph.
+   * Get the offset of an edge in the graph (binary search, if sorted).
    * @param u source vertex id
    * @param v target vertex id
    * @returns offset of the edge, or -1 if it does not exist
@@ -523,6 +528,10 @@ class DiGraphCsr {
     size_t  d = degrees[u];
     auto   ib = edgeKeys.begin() + i;
     auto   ie = edgeKeys.begin() + i + d;
+    if (sorted) {
+      auto it = lower_bound(ib, ie, v);
+      return it!=ie && *it==v? it - edgeKeys.begin() : size_t(-1);
+    }
     auto   it = find(ib, ie, v);
     return it!=ie? it - edgeKeys.begin() : size_t(-1);
   }
@@ -670,6 +679,487 @@ class DiGraphCsr {
   }
   #pragma endregion
 };
+
+
+
+/**
+ * A read-only view of a directed graph with CSR representation, over
+ * externally owned arrays (e.g. a memory mapped CSR snapshot).
+ * @tparam K key type (vertex id)
+ * @tparam V vertex value type (vertex data)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ */
+template <class K=uint32_t, class V=None, class E=None, class O=size_t>
+class DiGraphCsrView {
+  #pragma region TYPES
+  public:
+  /** Key type (vertex id). */
+  using key_type = K;
+  /** Vertex value type (vertex data). */
+  using vertex_value_type = V;
+  /** Edge value type (edge weight). */
+  using edge_value_type   = E;
+  /** Offset type (edge offset). */
+  using offset_type       = O;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Number of vertices. */
+  size_t N = 0;
+  /** Number of edges. */
+  size_t M = 0;
+  /** Offsets of the outgoing edges of vertices [N+1]. */
+  const O *offsets    = nullptr;
+  /** Vertex values [N], if any. */
+  const V *values     = nullptr;
+  /** Vertex ids of the outgoing edges of each vertex [M]. */
+  const K *edgeKeys   = nullptr;
+  /** Edge weights of the outgoing edges of each vertex [M], if any. */
+  const E *edgeValues = nullptr;
+  /** Are the outgoing edges of each vertex sorted by target vertex id? */
+  bool sorted = false;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  #pragma region PROPERTIES
+  public:
+  /**
+   * Get the size of buffer required to store data associated with each vertex
+   * in the graph, indexed by its vertex-id.
+   * @returns size of buffer required
+   */
+  inline size_t span() const noexcept {
+    return N;
+  }
+
+  /**
+   * Get the number of vertices in the graph.
+   * @returns |V|
+   */
+  inline size_t order() const noexcept {
+    return N;
+  }
+
+  /**
+   * Get the number of edges in the graph.
+   * @returns |E|
+   */
+  inline size_t size() const noexcept {
+    return M;
+  }
+
+  /**
+   * Check if the graph is empty.
+   * @returns is the graph empty?
+   */
+  inline bool empty() const noexcept {
+    return N == 0;
+  }
+
+  /**
+   * Check if the graph is directed.
+   * @returns is the graph directed?
+   */
+  inline bool directed() const noexcept {
+    return true;
+  }
+  #pragma endregion
+
+
+  #pragma region FOREACH
+  public:
+  /**
+   * Iterate over the vertices in the graph.
+   * @param fp process function (vertex id, vertex data)
+   */
+  template <class FP>
+  inline void forEachVertex(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      fp(u, vertexValue(u));
+  }
+
+  /**
+   * Iterate over the vertex ids in the graph.
+   * @param fp process function (vertex id)
+   */
+  template <class FP>
+  inline void forEachVertexKey(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      fp(u);
+  }
+
+  /**
+   * Iterate over the outgoing edges of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id, edge weight)
+   */
+  template <class FP>
+  inline void forEachEdge(K u, FP fp) const noexcept {
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    for (; i<I; ++i)
+      fp(edgeKeys[i], edgeValues? edgeValues[i] : E());
+  }
+
+  /**
+   * Iterate over the target vertex ids of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id)
+   */
+  template <class FP>
+  inline void forEachEdgeKey(K u, FP fp) const noexcept {
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    for (; i<I; ++i)
+      fp(edgeKeys[i]);
+  }
+  #pragma endregion
+
+
+  #pragma region OFFSET
+  public:
+  /**
+   * Get the offset of an edge in the graph (binary search, if sorted).
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns offset of the edge, or -1 if it does not exist
+   */
+  inline size_t edgeOffset(K u, K v) const noexcept {
+    if (!hasVertex(u) || !hasVertex(v)) return size_t(-1);
+    auto ib = edgeKeys + offsets[u];
+    auto ie = edgeKeys + offsets[u+1];
+    if (sorted) {
+      auto it = lower_bound(ib, ie, v);
+      return it!=ie && *it==v? it - edgeKeys : size_t(-1);
+    }
+    auto it = find(ib, ie, v);
+    return it!=ie? it - edgeKeys : size_t(-1);
+  }
+  #pragma endregion
+
+
+  #pragma region ACCESS
+  public:
+  /**
+   * Check if a vertex exists in the graph.
+   * @param u vertex id
+   * @returns does the vertex exist?
+   */
+  inline bool hasVertex(K u) const noexcept {
+    return u < span();
+  }
+
+  /**
+   * Check if an edge exists in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns does the edge exist?
+   */
+  inline bool hasEdge(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    return o != size_t(-1);
+  }
+
+  /**
+   * Get the number of outgoing edges of a vertex in the graph.
+   * @param u vertex id
+   * @returns number of outgoing edges of the vertex
+   */
+  inline size_t degree(K u) const noexcept {
+    return u < span()? offsets[u+1] - offsets[u] : 0;
+  }
+
+  /**
+   * Get the vertex data of a vertex in the graph.
+   * @param u vertex id
+   * @returns associated data of the vertex
+   */
+  inline V vertexValue(K u) const noexcept {
+    return u < span() && values? values[u] : V();
+  }
+
+  /**
+   * Get the edge weight of an edge in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns associated weight of the edge
+   */
+  inline E edgeValue(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    return o != size_t(-1) && edgeValues? edgeValues[o] : E();
+  }
+  #pragma endregion
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create an empty view of a CSR graph.
+   */
+  DiGraphCsrView() {}
+
+
+  /**
+   * Create a view of a CSR graph over existing arrays.
+   * @param n number of vertices
+   * @param m number of edges
+   * @param offsets CSR offsets [n+1]
+   * @param edgeKeys CSR edge keys [m]
+   * @param edgeValues CSR edge values [m], or nullptr
+   * @param values vertex values [n], or nullptr
+   */
+  DiGraphCsrView(size_t n, size_t m, const O *offsets, const K *edgeKeys, const E *edgeValues=nullptr, const V *values=nullptr) :
+  N(n), M(m), offsets(offsets), values(values), edgeKeys(edgeKeys), edgeValues(edgeValues) {}
+  #pragma endregion
+};
+
+
+/**
+ * A directed graph with compressed CSR representation, where the sorted
+ * outgoing edges of each vertex are stored as gaps, encoded as varints.
+ * @tparam K key type (vertex id)
+ * @tparam V vertex value type (vertex data)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ */
+template <class K=uint32_t, class V=None, class E=None, class O=size_t>
+class DiGraphCsrCompressed {
+  #pragma region TYPES
+  public:
+  /** Key type (vertex id). */
+  using key_type = K;
+  /** Vertex value type (vertex data). */
+  using vertex_value_type = V;
+  /** Edge value type (edge weight). */
+  using edge_value_type   = E;
+  /** Offset type (edge offset). */
+  using offset_type       = O;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Offsets of the outgoing edges of vertices (lookup for edge values). */
+  vector<O> offsets;
+  /** Byte offsets of the encoded outgoing edges of vertices (lookup for edge data). */
+  vector<O> dataOffsets;
+  /** Vertex values. */
+  vector<V> values;
+  /** Gap-encoded vertex ids of the outgoing edges of each vertex, as varints (lookup using dataOffsets). */
+  vector<uint8_t> edgeData;
+  /** Edge weights of the outgoing edges of each vertex (lookup using offsets). */
+  vector<E> edgeValues;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  #pragma region PROPERTIES
+  public:
+  /**
+   * Get the size of buffer required to store data associated with each vertex
+   * in the graph, indexed by its vertex-id.
+   * @returns size of buffer required
+   */
+  inline size_t span() const noexcept {
+    return offsets.size() - 1;
+  }
+
+  /**
+   * Get the number of vertices in the graph.
+   * @returns |V|
+   */
+  inline size_t order() const noexcept {
+    return offsets.size() - 1;
+  }
+
+  /**
+   * Get the number of edges in the graph.
+   * @returns |E|
+   */
+  inline size_t size() const noexcept {
+    return offsets.back();
+  }
+
+  /**
+   * Check if the graph is empty.
+   * @returns is the graph empty?
+   */
+  inline bool empty() const noexcept {
+    return order() == 0;
+  }
+
+  /**
+   * Check if the graph is directed.
+   * @returns is the graph directed?
+   */
+  inline bool directed() const noexcept {
+    return true;
+  }
+  #pragma endregion
+
+
+  #pragma region FOREACH
+  public:
+  /**
+   * Iterate over the vertices in the graph.
+   * @param fp process function (vertex id, vertex data)
+   */
+  template <class FP>
+  inline void forEachVertex(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      fp(u, values[u]);
+  }
+
+  /**
+   * Iterate over the vertex ids in the graph.
+   * @param fp process function (vertex id)
+   */
+  template <class FP>
+  inline void forEachVertexKey(FP fp) const noexcept {
+    for (K u=0; u<span(); ++u)
+      fp(u);
+  }
+
+  /**
+   * Iterate over the outgoing edges of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id, edge weight)
+   */
+  template <class FP>
+  inline void forEachEdge(K u, FP fp) const noexcept {
+    const uint8_t *x = edgeData.data() + dataOffsets[u];
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    uint64_t v = 0, g = 0;
+    for (; i<I; ++i) {
+      x = readVarintW(g, x); v += g;
+      fp(K(v), edgeValues.empty()? E() : edgeValues[i]);
+    }
+  }
+
+  /**
+   * Iterate over the target vertex ids of a source vertex in the graph.
+   * @param u source vertex id
+   * @param fp process function (target vertex id)
+   */
+  template <class FP>
+  inline void forEachEdgeKey(K u, FP fp) const noexcept {
+    const uint8_t *x = edgeData.data() + dataOffsets[u];
+    size_t d = offsets[u+1] - offsets[u];
+    uint64_t v = 0, g = 0;
+    for (; d>0; --d) {
+      x = readVarintW(g, x); v += g;
+      fp(K(v));
+    }
+  }
+  #pragma endregion
+
+
+  #pragma region OFFSET
+  public:
+  /**
+   * Get the offset of an edge in the graph (decodes edges until found).
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns offset of the edge, or -1 if it does not exist
+   */
+  inline size_t edgeOffset(K u, K v) const noexcept {
+    if (!hasVertex(u) || !hasVertex(v)) return size_t(-1);
+    const uint8_t *x = edgeData.data() + dataOffsets[u];
+    size_t i = offsets[u];
+    size_t I = offsets[u+1];
+    uint64_t c = 0, g = 0;
+    for (; i<I; ++i) {
+      x = readVarintW(g, x); c += g;
+      if (c >= v) return c==v? i : size_t(-1);
+    }
+    return size_t(-1);
+  }
+  #pragma endregion
+
+
+  #pragma region ACCESS
+  public:
+  /**
+   * Check if a vertex exists in the graph.
+   * @param u vertex id
+   * @returns does the vertex exist?
+   */
+  inline bool hasVertex(K u) const noexcept {
+    return u < span();
+  }
+
+  /**
+   * Check if an edge exists in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns does the edge exist?
+   */
+  inline bool hasEdge(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    return o != size_t(-1);
+  }
+
+  /**
+   * Get the number of outgoing edges of a vertex in the graph.
+   * @param u vertex id
+   * @returns number of outgoing edges of the vertex
+   */
+  inline size_t degree(K u) const noexcept {
+    return u < span()? offsets[u+1] - offsets[u] : 0;
+  }
+
+  /**
+   * Get the vertex data of a vertex in the graph.
+   * @param u vertex id
+   * @returns associated data of the vertex
+   */
+  inline V vertexValue(K u) const noexcept {
+    return u < span()? values[u] : V();
+  }
+
+  /**
+   * Set the vertex data of a vertex in the graph.
+   * @param u vertex id
+   * @param d associated data of the vertex
+   * @returns success?
+   */
+  inline bool setVertexValue(K u, V d) noexcept {
+    if (!hasVertex(u)) return false;
+    values[u] = d;
+    return true;
+  }
+
+  /**
+   * Get the edge weight of an edge in the graph.
+   * @param u source vertex id
+   * @param v target vertex id
+   * @returns associated weight of the edge
+   */
+  inline E edgeValue(K u, K v) const noexcept {
+    size_t o = edgeOffset(u, v);
+    return o != size_t(-1) && !edgeValues.empty()? edgeValues[o] : E();
+  }
+  #pragma endregion
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create an empty compressed CSR representation of a directed graph.
+   */
+  DiGraphCsrCompressed() {
+    offsets.push_back(0);
+    dataOffsets.push_back(0);
+  }
+  #pragma endregion
+};
 #pragma endregion
 
 
@@ -738,8 +1228,32 @@ inline void write(ostream& a, const DiGraph<K, V, E>& x, bool detailed=false) {
  * @param x csr graph
  * @param detailed write detailed information?
  */
+template <class K, class V, class E, class O, tclass1 S>
+inline void write(ostream& a, const DiGraphCsr<K, V, E, O, S>& x, bool detailed=false) {
+  writeGraph(a, x, detailed);
+}
+
+
+/**
+ * Write a graph to an output stream.
+ * @param a output stream
+ * @param x csr graph view
+ * @param detailed write detailed information?
+ */
 template <class K, class V, class E, class O>
-inline void write(ostream& a, const DiGraphCsr<K, V, E, O>& x, bool detailed=false) {
+inline void write(ostream& a, const DiGraphCsrView<K, V, E, O>& x, bool detailed=false) {
+  writeGraph(a, x, detailed);
+}
+
+
+/**
+ * Write a graph to an output stream.
+ * @param a output stream
+ * @param x compressed csr graph
+ * @param detailed write detailed information?
+ */
+template <class K, class V, class E, class O>
+inline void write(ostream& a, const DiGraphCsrCompressed<K, V, E, O>& x, bool detailed=false) {
   writeGraph(a, x, detailed);
 }
 
@@ -761,10 +1275,148 @@ inline ostream& operator<<(ostream& a, const DiGraph<K, V, E>& x) {
  * @param a output stream
  * @param x csr graph
  */
+template <class K, class V, class E, class O, tclass1 S>
+inline ostream& operator<<(ostream& a, const DiGraphCsr<K, V, E, O, S>& x) {
+  write(a, x);
+  return a;
+}
+
+
+/**
+ * Write only the sizes of a graph to an output stream.
+ * @param a output stream
+ * @param x csr graph view
+ */
+template <class K, class V, class E, class O>
+inline ostream& operator<<(ostream& a, const DiGraphCsrView<K, V, E, O>& x) {
+  write(a, x);
+  return a;
+}
+
+
+/**
+ * Write only the sizes of a graph to an output stream.
+ * @param a output stream
+ * @param x compressed csr graph
+ */
 template <class K, class V, class E, class O>
-inline ostream& operator<<(ostream& a, const DiGraphCsr<K, V, E, O>& x) {
+inline ostream& operator<<(ostream& a, const DiGraphCsrCompressed<K, V, E, O>& x) {
   write(a, x);
   return a;
 }
 #pragma endregion
+
+
+
+
+#pragma region COMPRESS
+/**
+ * Compress CSR by encoding the gaps between sorted edges of each vertex as varints.
+ * @tparam WEIGHTED is graph weighted?
+ * @param a compressed CSR (output)
+ * @param offsets CSR offsets
+ * @param edgeKeys CSR edge keys (must be sorted for each vertex, else FormatError is thrown)
+ * @param edgeValues CSR edge values
+ * @param rows number of rows/vertices
+ */
+template <bool WEIGHTED=false, class K, class V, class E, class O, class IO, class IK, class IE>
+inline void compressCsrW(DiGraphCsrCompressed<K, V, E, O>& a, IO offsets, IK edgeKeys, IE edgeValues, size_t rows) {
+  const size_t M = offsets[rows];
+  a.offsets.resize(rows+1);
+  a.dataOffsets.resize(rows+1);
+  a.values.resize(rows);
+  a.edgeValues.resize(WEIGHTED? M : 0);
+  // Compute byte offsets of encoded edges.
+  O b = O();
+  for (size_t u=0; u<rows; ++u) {
+    a.offsets[u] = offsets[u];
+    a.dataOffsets[u] = b;
+    K p = K();
+    for (size_t i=offsets[u]; i<offsets[u+1]; ++i) {
+      if (K(edgeKeys[i]) < p) throw FormatError("Invalid CSR (unsorted edges)");
+      b += varintBytes(K(edgeKeys[i] - p));
+      p  = edgeKeys[i];
+    }
+  }
+  a.offsets[rows] = M;
+  a.dataOffsets[rows] = b;
+  // Encode edges.
+  a.edgeData.resize(b);
+  uint8_t *x = a.edgeData.data();
+  for (size_t u=0; u<rows; ++u) {
+    K p = K();
+    for (size_t i=offsets[u]; i<offsets[u+1]; ++i) {
+      x = writeVarintW(x, K(edgeKeys[i] - p));
+      p = edgeKeys[i];
+      if constexpr (WEIGHTED) a.edgeValues[i] = edgeValues[i];
+    }
+  }
+}
+
+
+#ifdef OPENMP
+/**
+ * Compress CSR by encoding the gaps between sorted edges of each vertex as varints, in parallel.
+ * @tparam WEIGHTED is graph weighted?
+ * @param a compressed CSR (output)
+ * @param offsets CSR offsets
+ * @param edgeKeys CSR edge keys (must be sorted for each vertex, else FormatError is thrown)
+ * @param edgeValues CSR edge values
+ * @param rows number of rows/vertices
+ */
+template <bool WEIGHTED=false, class K, class V, class E, class O, class IO, class IK, class IE>
+inline void compressCsrOmpW(DiGraphCsrCompressed<K, V, E, O>& a, IO offsets, IK edgeKeys, IE edgeValues, size_t rows) {
+  const size_t M = offsets[rows];
+  const int    T = omp_get_max_threads();
+  a.offsets.resize(rows+1);
+  a.dataOffsets.resize(rows+1);
+  a.values.resize(rows);
+  a.edgeValues.resize(WEIGHTED? M : 0);
+  // Compute encoded size of edges of each vertex.
+  bool sorted = true;
+  #pragma omp parallel for schedule(dynamic, 2048) reduction(&&:sorted)
+  for (size_t u=0; u<rows; ++u) {
+    O b = O();
+    K p = K();
+    for (size_t i=offsets[u]; i<offsets[u+1]; ++i) {
+      sorted = sorted && !(K(edgeKeys[i]) < p);
+      b += varintBytes(K(edgeKeys[i] - p));
+      p  = edgeKeys[i];
+    }
+    a.offsets[u] = offsets[u];
+    a.dataOffsets[u] = b;
+  }
+  if (!sorted) throw FormatError("Invalid CSR (unsorted edges)");
+  a.offsets[rows] = M;
+  // Compute byte offsets of encoded edges.
+  vector<O> buf(T);
+  a.dataOffsets[rows] = exclusiveScanOmpW(a.dataOffsets.data(), buf.data(), a.dataOffsets.data(), rows);
+  // Encode edges.
+  a.edgeData.resize(a.dataOffsets[rows]);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<rows; ++u) {
+    uint8_t *x = a.edgeData.data() + a.dataOffsets[u];
+    K p = K();
+    for (size_t i=offsets[u]; i<offsets[u+1]; ++i) {
+      x = writeVarintW(x, K(edgeKeys[i] - p));
+      p = edgeKeys[i];
+      if constexpr (WEIGHTED) a.edgeValues[i] = edgeValues[i];
+    }
+  }
+}
+
+
+/**
+ * Compress a sorted CSR graph by encoding the gaps between edges of each vertex as varints, in parallel.
+ * @tparam WEIGHTED is graph weighted?
+ * @param a compressed CSR (output)
+ * @param x CSR graph (must be marked sorted, else FormatError is thrown)
+ */
+template <bool WEIGHTED=false, class K, class V, class E, class O, tclass1 S>
+inline void compressCsrOmpW(DiGraphCsrCompressed<K, V, E, O>& a, const DiGraphCsr<K, V, E, O, S>& x) {
+  if (!x.sorted) throw FormatError("Invalid CSR (not marked sorted)");
+  compressCsrOmpW<WEIGHTED>(a, x.offsets.data(), x.edgeKeys.data(), x.edgeValues.data(), x.order());
+}
+#endif
+#pragma endregion
 #pragma endregion
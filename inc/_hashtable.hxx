@@ -0,0 +1,154 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "_mman.hxx"
+
+using std::move;
+
+
+
+
+#pragma region CLASSES
+/**
+ * A concurrent hash table from 64-bit keys to values, with linear probing.
+ * Keys are inserted by many threads at once, claiming empty slots with CAS;
+ * values are assigned after insertion (e.g. dense ids), and then looked up.
+ * Memory is allocated with mmap(), so empty slots need no initialization.
+ * @tparam V value type
+ */
+template <class V=uint32_t>
+class ConcurrentHashTable {
+  #pragma region TYPES
+  public:
+  /** Key type. */
+  using key_type   = uint64_t;
+  /** Value type. */
+  using value_type = V;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Number of slots (power of 2). */
+  size_t capacity = 0;
+  /** Keys of slots, plus one (zero for empty slots). */
+  MappedPtr<uint64_t> keys;
+  /** Values of slots, and of the largest key (at capacity), which cannot be stored in a slot. */
+  MappedPtr<V> values;
+  /** Is the largest key present? */
+  bool largest = false;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  #pragma region HASH
+  public:
+  /**
+   * Get the home slot of a key (splitmix64 finalizer).
+   * @param k key
+   * @returns slot index
+   */
+  inline size_t slot(uint64_t k) const noexcept {
+    k = (k ^ (k >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    k = (k ^ (k >> 27)) * 0x94D049BB133111EBULL;
+    return (k ^ (k >> 31)) & (capacity-1);
+  }
+  #pragma endregion
+
+
+  #pragma region ACCESS
+  public:
+  /**
+   * Insert a key (thread-safe).
+   * @param k key
+   * @returns was the key newly inserted?
+   * @note The table must not be full (keep load factor below 1).
+   */
+  inline bool insert(uint64_t k) noexcept {
+    if (k==uint64_t(-1)) {
+      bool a = false;
+      #pragma omp atomic capture
+      { a = largest; largest = true; }
+      return !a;
+    }
+    const uint64_t K = k+1;
+    for (size_t i=slot(k);; i=(i+1) & (capacity-1)) {
+      uint64_t x = __atomic_load_n(&keys[i], __ATOMIC_RELAXED);
+      if (x==K) return false;
+      if (x!=0) continue;
+      if (__atomic_compare_exchange_n(&keys[i], &x, K, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return true;
+      if (x==K) return false;  // Claimed by another thread, for the same key
+    }
+  }
+
+  /**
+   * Find the slot of a key.
+   * @param k key
+   * @returns slot index (capacity for the largest key), or -1 if not present
+   * @note Not thread-safe with concurrent insertions.
+   */
+  inline size_t find(uint64_t k) const noexcept {
+    if (k==uint64_t(-1)) return largest? capacity : size_t(-1);
+    const uint64_t K = k+1;
+    for (size_t i=slot(k);; i=(i+1) & (capacity-1)) {
+      uint64_t x = keys[i];
+      if (x==K) return i;
+      if (x==0) return size_t(-1);
+    }
+  }
+
+  /**
+   * Get the value of a key (must be present).
+   * @param k key
+   * @returns value of key
+   */
+  inline V get(uint64_t k) const noexcept {
+    return values[find(k)];
+  }
+
+  /**
+   * Get the key of a slot, if occupied.
+   * @param a key of the slot (output)
+   * @param i slot index
+   * @returns is the slot occupied?
+   */
+  inline bool keyAt(uint64_t& a, size_t i) const noexcept {
+    a = keys[i]-1;
+    return keys[i]!=0;
+  }
+  #pragma endregion
+
+
+  #pragma region UPDATE
+  public:
+  /**
+   * Grow the table, and reinsert all keys (values are not kept).
+   * @param n new number of slots (power of 2)
+   */
+  inline void rehashOmp(size_t n) {
+    ConcurrentHashTable<V> a(n);
+    a.largest = largest;
+    #pragma omp parallel for schedule(static, 4096)
+    for (size_t i=0; i<capacity; ++i)
+      if (keys[i]) a.insert(keys[i]-1);
+    *this = move(a);
+  }
+  #pragma endregion
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create an empty hash table.
+   * @param capacity number of slots (power of 2)
+   */
+  ConcurrentHashTable(size_t capacity) :
+  capacity(capacity),
+  keys(capacity * sizeof(uint64_t), HUGE_PAGES_TRANSPARENT),
+  values((capacity+1) * sizeof(V), HUGE_PAGES_TRANSPARENT) {
+    if (!keys || !values) throw std::bad_alloc();
+  }
+  #pragma endregion
+};
+#pragma endregion
@@ -7,9 +7,12 @@
 #include "_queue.hxx"
 #include "_bitset.hxx"
 #include "_mman.hxx"
+#include "_hashtable.hxx"
 #include "_memory.hxx"
 #include "_utility.hxx"
+#include "_simd.hxx"
 #include "_string.hxx"
+#include "_varint.hxx"
 #include "_vector.hxx"
 #ifdef OPENMP
 #include "_openmp.hxx"
@@ -1,6 +1,10 @@
 #pragma once
 #include <tuple>
 #include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <type_traits>
 #include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -9,6 +13,25 @@
 
 using std::tuple;
 using std::tie;
+using std::memcpy;
+using std::memset;
+using std::is_trivially_copyable;
+
+
+
+
+#pragma region HUGE PAGE MODES
+#ifndef HUGE_PAGES_NONE
+/** Use regular (4KB) pages only. */
+#define HUGE_PAGES_NONE         0
+/** Use transparent huge pages (2MB aligned, with MADV_HUGEPAGE). */
+#define HUGE_PAGES_TRANSPARENT  1
+/** Use explicit huge pages (MAP_HUGETLB), or transparent ones if none are reserved. */
+#define HUGE_PAGES_EXPLICIT     2
+/** Size of a huge page. */
+#define HUGE_PAGE_SIZE          (size_t(1) << 21)
+#endif
+#pragma endregion
 
 
 
@@ -132,6 +155,45 @@ inline void* mmapAlloc(size_t size) {
 }
 
 
+/**
+ * Get the size of memory actually allocated by mmapAlloc(), for a huge page mode.
+ * Allocations of at least a huge page are rounded up to a multiple of huge pages.
+ * @param size memory size
+ * @param huge huge page mode (HUGE_PAGES_*)
+ * @returns allocation size
+ */
+inline size_t mmapAllocSize(size_t size, int huge) {
+  if (huge==HUGE_PAGES_NONE || size<HUGE_PAGE_SIZE) return size;
+  return (size + HUGE_PAGE_SIZE-1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+
+/**
+ * Allocate memory using mmap, optionally backed by huge pages.
+ * Memory is not touched, so pages are placed on first touch (and are zero).
+ * @param size memory size (must be mmapAllocSize(size, huge))
+ * @param huge huge page mode (HUGE_PAGES_*)
+ * @returns allocated memory
+ */
+inline void* mmapAlloc(size_t size, int huge) {
+  if (huge==HUGE_PAGES_NONE || size<HUGE_PAGE_SIZE) return mmapAlloc(size);
+  // Try explicit huge pages, if reserved.
+  if (huge==HUGE_PAGES_EXPLICIT) {
+    void *a = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (a!=MAP_FAILED) return a;
+  }
+  // Align to a huge page (trim the ends), and ask for transparent huge pages.
+  void *a = mmapAlloc(size + HUGE_PAGE_SIZE);
+  if (a==MAP_FAILED) return a;
+  size_t b = size_t(a);
+  size_t B = (b + HUGE_PAGE_SIZE-1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (B>b) munmap(a, B-b);
+  if (B<b+HUGE_PAGE_SIZE) munmap((void*) (B+size), b+HUGE_PAGE_SIZE - B);
+  madvise((void*) B, size, MADV_HUGEPAGE);
+  return (void*) B;
+}
+
+
 /**
  * Free memory allocated using mmap.
  * @param addr memory address
@@ -198,12 +260,42 @@ struct MappedPtr {
   /**
    * Allocate memory using mmap().
    * @param size size of memory to allocate
+   * @param huge huge page mode (HUGE_PAGES_*)
    */
-  MappedPtr(size_t size) {
-    _data = (T*) mmapAlloc(size);
+  MappedPtr(size_t size, int huge=HUGE_PAGES_NONE) : _data(nullptr), _size(0) {
+    if (size==0) return;
+    size = mmapAllocSize(size, huge);
+    void *data = mmapAlloc(size, huge);
+    if (data==MAP_FAILED) return;
+    _data = (T*) data;
     _size = size;
   }
 
+  /**
+   * Take over memory allocated by another MappedPtr.
+   * @param x another allocation (emptied)
+   */
+  MappedPtr(MappedPtr&& x) noexcept : _data(x._data), _size(x._size) {
+    x._data = nullptr;
+    x._size = 0;
+  }
+
+  /**
+   * Take over memory allocated by another MappedPtr, freeing current memory.
+   * @param x another allocation (emptied)
+   * @returns this allocation
+   */
+  MappedPtr& operator=(MappedPtr&& x) noexcept {
+    if (this == &x) return *this;
+    release();
+    _data = x._data; x._data = nullptr;
+    _size = x._size; x._size = 0;
+    return *this;
+  }
+
+  MappedPtr(const MappedPtr&) = delete;
+  MappedPtr& operator=(const MappedPtr&) = delete;
+
   /**
    * Free memory allocated using mmap().
    */
@@ -211,3 +303,261 @@ struct MappedPtr {
   #pragma endregion
 };
 #pragma endregion
+
+
+
+
+#pragma region FIRST TOUCH
+#ifdef OPENMP
+/**
+ * Place the pages of an untouched array by parallel first touch.
+ * Pages are touched with a static schedule over pages, which only gives an
+ * even interleave of pages across threads (and their NUMA nodes). It does not
+ * match the schedules of later writers, and huge pages are placed per 2MB.
+ * @param a array (untouched, updated)
+ * @param N number of elements
+ */
+template <class T>
+inline void firstTouchOmpU(T *a, size_t N) {
+  const size_t PAGE = 4096;
+  const size_t P = (N * sizeof(T) + PAGE-1) / PAGE;
+  volatile char *x = (volatile char*) a;
+  #pragma omp parallel for schedule(static)
+  for (size_t p=0; p<P; ++p)
+    x[p * PAGE] = 0;
+}
+
+
+/**
+ * Zero an array in parallel.
+ * @param a array (updated)
+ * @param N number of elements
+ */
+template <class T>
+inline void fillZeroOmpU(T *a, size_t N) {
+  const size_t BLOCK = 65536;  // Bytes per block
+  const size_t B = N * sizeof(T);
+  char *x = (char*) a;
+  #pragma omp parallel for schedule(static)
+  for (size_t i=0; i<B; i+=BLOCK)
+    memset(x+i, 0, B-i<BLOCK? B-i : BLOCK);
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region MAPPED VECTOR
+/**
+ * A vector of trivially copyable values, allocated with mmap().
+ * Unlike std::vector, resizing does not initialize new values serially;
+ * fresh pages are zero, and are placed by parallel first touch. Only reused
+ * memory (after shrinking) is zeroed again, in parallel.
+ * @tparam T value type
+ * @tparam HUGE huge page mode (HUGE_PAGES_*)
+ */
+template <class T, int HUGE=HUGE_PAGES_TRANSPARENT>
+class MappedVector {
+  static_assert(is_trivially_copyable<T>::value, "MappedVector needs trivially copyable values");
+  #pragma region TYPES
+  public:
+  /** Value type. */
+  using value_type = T;
+  /** Iterator type. */
+  using iterator   = T*;
+  /** Constant iterator type. */
+  using const_iterator = const T*;
+  #pragma endregion
+
+
+  #pragma region DATA
+  private:
+  /** Allocated memory. */
+  MappedPtr<T> _ptr;
+  /** Number of values. */
+  size_t _size = 0;
+  /** Number of values written since allocation (memory beyond is still zero). */
+  size_t _dirty = 0;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  #pragma region PROPERTIES
+  public:
+  /**
+   * Get the number of values.
+   * @returns number of values
+   */
+  inline size_t size() const noexcept { return _size; }
+
+  /**
+   * Get the number of values that fit in allocated memory.
+   * @returns number of values
+   */
+  inline size_t capacity() const noexcept { return _ptr.size() / sizeof(T); }
+
+  /**
+   * Check if the vector is empty.
+   * @returns is empty?
+   */
+  inline bool empty() const noexcept { return _size==0; }
+  #pragma endregion
+
+
+  #pragma region ACCESS
+  public:
+  /**
+   * Get the values.
+   * @returns base address
+   */
+  inline T* data() noexcept { return _ptr.data(); }
+  inline const T* data() const noexcept { return _ptr.data(); }
+
+  /**
+   * Get a value.
+   * @param i index
+   * @returns value at index
+   */
+  inline T& operator[](size_t i) noexcept { return _ptr.data()[i]; }
+  inline const T& operator[](size_t i) const noexcept { return _ptr.data()[i]; }
+
+  /**
+   * Get the first value.
+   * @returns first value
+   */
+  inline T& front() noexcept { return _ptr.data()[0]; }
+  inline const T& front() const noexcept { return _ptr.data()[0]; }
+
+  /**
+   * Get the last value.
+   * @returns last value
+   */
+  inline T& back() noexcept { return _ptr.data()[_size-1]; }
+  inline const T& back() const noexcept { return _ptr.data()[_size-1]; }
+
+  /**
+   * Get an iterator to the beginning.
+   * @returns begin iterator
+   */
+  inline T* begin() noexcept { return _ptr.data(); }
+  inline const T* begin() const noexcept { return _ptr.data(); }
+
+  /**
+   * Get an iterator to the end.
+   * @returns end iterator
+   */
+  inline T* end() noexcept { return _ptr.data() + _size; }
+  inline const T* end() const noexcept { return _ptr.data() + _size; }
+  #pragma endregion
+
+
+  #pragma region UPDATE
+  public:
+  /**
+   * Ensure that at least n values fit in allocated memory.
+   * New memory is placed by parallel first touch, and existing values are copied over.
+   * @param n number of values
+   */
+  inline void reserve(size_t n) {
+    if (n<=capacity()) return;
+    MappedPtr<T> b(n * sizeof(T), HUGE);
+    if (b.data()==nullptr) throw std::bad_alloc();
+#ifdef OPENMP
+    firstTouchOmpU(b.data(), n);
+#endif
+    if (_size>0) memcpy(b.data(), _ptr.data(), _size * sizeof(T));
+    _ptr   = std::move(b);
+    _dirty = _size;
+  }
+
+  /**
+   * Change the number of values, with new values zero.
+   * Freshly allocated memory is already zero; reused memory is zeroed in parallel.
+   * @param n number of values
+   */
+  inline void resize(size_t n) {
+    reserve(n);
+    size_t I = n<_dirty? n : _dirty;
+    if (I>_size) {
+#ifdef OPENMP
+      fillZeroOmpU(_ptr.data() + _size, I - _size);
+#else
+      memset(_ptr.data() + _size, 0, (I - _size) * sizeof(T));
+#endif
+    }
+    _size  = n;
+    _dirty = n>_dirty? n : _dirty;
+  }
+
+  /**
+   * Add a value to the end.
+   * @param v value
+   */
+  inline void push_back(const T& v) {
+    if (_size==capacity()) reserve(_size<8? 8 : 2*_size);
+    _ptr.data()[_size++] = v;
+    if (_size>_dirty) _dirty = _size;
+  }
+
+  /**
+   * Remove all values (keeping allocated memory).
+   */
+  inline void clear() noexcept { _size = 0; }
+  #pragma endregion
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS / DESTRUCTORS
+  public:
+  /**
+   * Create an empty vector.
+   */
+  MappedVector() {}
+
+  /**
+   * Create a vector of n values (zero).
+   * @param n number of values
+   */
+  explicit MappedVector(size_t n) { resize(n); }
+
+  /**
+   * Copy another vector.
+   * @param x another vector
+   */
+  MappedVector(const MappedVector& x) { *this = x; }
+
+  /**
+   * Take over another vector.
+   * @param x another vector (emptied)
+   */
+  MappedVector(MappedVector&& x) noexcept : _ptr(std::move(x._ptr)), _size(x._size), _dirty(x._dirty) { x._size = 0; x._dirty = 0; }
+
+  /**
+   * Copy another vector, reusing allocated memory if possible.
+   * @param x another vector
+   * @returns this vector
+   */
+  MappedVector& operator=(const MappedVector& x) {
+    if (this == &x) return *this;
+    _size = 0;
+    resize(x._size);
+    if (_size>0) memcpy(_ptr.data(), x._ptr.data(), _size * sizeof(T));
+    return *this;
+  }
+
+  /**
+   * Take over another vector, freeing allocated memory.
+   * @param x another vector (emptied)
+   * @returns this vector
+   */
+  MappedVector& operator=(MappedVector&& x) noexcept {
+    if (this == &x) return *this;
+    _ptr   = std::move(x._ptr);
+    _size  = x._size;  x._size  = 0;
+    _dirty = x._dirty; x._dirty = 0;
+    return *this;
+  }
+  #pragma endregion
+};
+#pragma endregion
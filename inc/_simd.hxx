@@ -0,0 +1,205 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using std::memcpy;
+
+
+
+
+#pragma region SIMD LEVELS
+#ifndef SIMD_SCALAR
+/** No SIMD, scalar code only. */
+#define SIMD_SCALAR  0
+/** SSE2 instruction set. */
+#define SIMD_SSE2    1
+/** AVX2 instruction set. */
+#define SIMD_AVX2    2
+/** AVX-512 (BW) instruction set. */
+#define SIMD_AVX512  3
+#endif
+#pragma endregion
+
+
+
+
+#pragma region METHODS
+#pragma region SIMD SUPPORT
+/**
+ * Check if a SIMD level is supported by the current CPU.
+ * @param level SIMD level
+ * @returns is the level supported?
+ */
+inline bool simdSupported(int level) {
+#if defined(__x86_64__) || defined(__i386__)
+  switch (level) {
+    case SIMD_SCALAR: return true;
+    case SIMD_SSE2:   return __builtin_cpu_supports("sse2");
+    case SIMD_AVX2:   return __builtin_cpu_supports("avx2");
+    case SIMD_AVX512: return __builtin_cpu_supports("avx512bw");
+    default:          return false;
+  }
+#else
+  return level==SIMD_SCALAR;
+#endif
+}
+
+
+/**
+ * Get the highest SIMD level supported by the current CPU (cached).
+ * @returns SIMD level
+ */
+inline int simdLevel() {
+  static const int a = [] {
+    int l = SIMD_AVX512;
+    for (; l>SIMD_SCALAR; --l)
+      if (simdSupported(l)) break;
+    return l;
+  }();
+  return a;
+}
+
+
+/**
+ * Get the name of a SIMD level.
+ * @param level SIMD level
+ * @returns name of the level
+ */
+inline const char* simdName(int level) {
+  switch (level) {
+    case SIMD_SCALAR: return "Scalar";
+    case SIMD_SSE2:   return "Sse2";
+    case SIMD_AVX2:   return "Avx2";
+    case SIMD_AVX512: return "Avx512";
+    default:          return "Unknown";
+  }
+}
+#pragma endregion
+
+
+
+
+#pragma region DIGIT MASK
+/**
+ * Classify 64 characters as digits [0-9], without SIMD.
+ * @param x characters (at least 64)
+ * @returns bitmask of digits (bit i for x[i])
+ */
+inline uint64_t digitMask64Scalar(const char *x) {
+  uint64_t a = 0;
+  for (int i=0; i<64; ++i)
+    a |= uint64_t(uint8_t(x[i] - '0') <= 9) << i;
+  return a;
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Classify 64 characters as digits [0-9], with SSE2.
+ * @param x characters (at least 64)
+ * @returns bitmask of digits (bit i for x[i])
+ */
+__attribute__((target("sse2")))
+inline uint64_t digitMask64Sse2(const char *x) {
+  const __m128i c0 = _mm_set1_epi8('0');
+  const __m128i c9 = _mm_set1_epi8(9);
+  uint64_t a = 0;
+  for (int i=0; i<64; i+=16) {
+    __m128i d = _mm_sub_epi8(_mm_loadu_si128((const __m128i*) (x+i)), c0);
+    __m128i m = _mm_cmpeq_epi8(_mm_min_epu8(d, c9), d);  // d <= 9 (unsigned)
+    a |= uint64_t(uint32_t(_mm_movemask_epi8(m))) << i;
+  }
+  return a;
+}
+
+
+/**
+ * Classify 64 characters as digits [0-9], with AVX2.
+ * @param x characters (at least 64)
+ * @returns bitmask of digits (bit i for x[i])
+ */
+__attribute__((target("avx2")))
+inline uint64_t digitMask64Avx2(const char *x) {
+  const __m256i c0 = _mm256_set1_epi8('0');
+  const __m256i c9 = _mm256_set1_epi8(9);
+  __m256i d0 = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*) x),      c0);
+  __m256i d1 = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i*) (x+32)), c0);
+  __m256i m0 = _mm256_cmpeq_epi8(_mm256_min_epu8(d0, c9), d0);  // d <= 9 (unsigned)
+  __m256i m1 = _mm256_cmpeq_epi8(_mm256_min_epu8(d1, c9), d1);
+  uint64_t a0 = uint32_t(_mm256_movemask_epi8(m0));
+  uint64_t a1 = uint32_t(_mm256_movemask_epi8(m1));
+  return a0 | (a1 << 32);
+}
+
+
+/**
+ * Classify 64 characters as digits [0-9], with AVX-512 (BW).
+ * @param x characters (at least 64)
+ * @returns bitmask of digits (bit i for x[i])
+ */
+__attribute__((target("avx512f,avx512bw")))
+inline uint64_t digitMask64Avx512(const char *x) {
+  const __m512i c0 = _mm512_set1_epi8('0');
+  const __m512i c9 = _mm512_set1_epi8(9);
+  __m512i d = _mm512_sub_epi8(_mm512_loadu_si512((const void*) x), c0);
+  return _mm512_cmple_epu8_mask(d, c9);
+}
+#endif
+
+
+/**
+ * Classify 64 characters as digits [0-9], at a SIMD level chosen at compile time.
+ * @tparam LEVEL SIMD level (must be supported, and enabled in the caller with a matching target)
+ * @param x characters (at least 64)
+ * @returns bitmask of digits (bit i for x[i])
+ */
+template <int LEVEL>
+inline uint64_t digitMask64(const char *x) {
+#if defined(__x86_64__) || defined(__i386__)
+  if constexpr (LEVEL==SIMD_SSE2)   return digitMask64Sse2(x);
+  if constexpr (LEVEL==SIMD_AVX2)   return digitMask64Avx2(x);
+  if constexpr (LEVEL==SIMD_AVX512) return digitMask64Avx512(x);
+#endif
+  return digitMask64Scalar(x);
+}
+#pragma endregion
+
+
+
+
+#pragma region PARSE DIGITS
+/**
+ * Parse 8 packed digit characters into a number (SWAR).
+ * @param x packed characters (first digit in lowest byte)
+ * @returns parsed number
+ */
+inline uint64_t parseEightDigitsSwar(uint64_t x) {
+  x = ((x & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  x = ((x & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  return ((x & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32;
+}
+
+
+/**
+ * Parse up to 8 digit characters into a number (SWAR).
+ * @param x digit characters (8 bytes must be readable)
+ * @param n number of digits [1-8]
+ * @returns parsed number
+ */
+inline uint64_t parseDigitsSwar(const char *x, int n) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t a; memcpy(&a, x, 8);
+  a = (a & 0x0F0F0F0F0F0F0F0FULL) << (8 * (8-n));  // Leading zeros
+  return parseEightDigitsSwar(a);
+#else
+  uint64_t a = 0;
+  for (int i=0; i<n; ++i)
+    a = a*10 + (x[i] - '0');
+  return a;
+#endif
+}
+#pragma endregion
+#pragma endregion
@@ -10,6 +10,7 @@
 #include "_exception.hxx"
 
 using std::is_integral;
+using std::is_unsigned;
 using std::is_floating_point;
 using std::pair;
 using std::string_view;
@@ -171,6 +172,30 @@ inline pair<I, I> findNextToken(I ib, I ie, FU fu, FW fw) {
 
 
 
+#pragma region POWER OF 10
+/**
+ * Get an integral power of 10, using a lookup table for common exponents.
+ * @param e exponent
+ * @returns 10^e
+ */
+inline double powerOf10(int e) {
+  static constexpr double POS[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  static constexpr double NEG[] = {
+    1e-0,  1e-1,  1e-2,  1e-3,  1e-4,  1e-5,  1e-6,  1e-7,  1e-8,  1e-9,  1e-10, 1e-11,
+    1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19, 1e-20, 1e-21, 1e-22
+  };
+  if (e>=0 && e<=22)  return POS[e];
+  if (e<0  && e>=-22) return NEG[-e];
+  return pow(10.0, e);
+}
+#pragma endregion
+
+
+
+
 #pragma region PARSE NUMBER
 /**
  * Parse a whole number from a string.
@@ -183,8 +208,12 @@ inline pair<I, I> findNextToken(I ib, I ie, FU fu, FW fw) {
 template <int FULL=0, class T, class I>
 inline I parseWholeNumberW(T &a, I ib, I ie) {
   a = T();
-  for (; ib!=ie && (FULL==1 || isDigit(*ib)); ++ib)
-    a = a*10 + (*ib - '0');
+  for (; ib!=ie && (FULL==1 || isDigit(*ib)); ++ib) {
+    if constexpr (FULL==2 && is_integral<T>::value) {
+      if (__builtin_mul_overflow(a, T(10), &a) || __builtin_add_overflow(a, T(*ib - '0'), &a)) throw FormatError("Failed to parse number (overflow)", ib);
+    }
+    else a = a*10 + (*ib - '0');
+  }
   return ib;
 }
 
@@ -203,6 +232,7 @@ inline I parseIntegerW(T &a, I ib, I ie) {
   if (ib==ie) return ib;
   // Handle sign.
   bool neg = *ib=='-';
+  if constexpr (FULL==2 && is_unsigned<T>::value) { if (neg) throw FormatError("Failed to parse number (negative unsigned)", ib); }
   if (*ib=='-' || *ib=='+') ++ib;
   // Scan whole number.
   ib = parseWholeNumberW<FULL>(a, ib, ie);
@@ -235,7 +265,7 @@ inline I parseFloatW(T &a, I ib, I ie) {
   if (ib!=ie && *ib=='.') { I id = ++ib; ib = parseWholeNumberW(v, ib, ie); d = int(ib-id); }
   if (ib!=ie && (*ib=='e' || *ib=='E'))  ib = parseIntegerW<FULL>(e, ib+1, ie);
   // Compute number, and apply sign.
-  a = (T(u) + T(v) * pow(10, -d)) * T(pow(10, e));
+  a = (T(u) + T(v) * powerOf10(-d)) * T(powerOf10(e));
   if (neg) a = -a;
   return ib;
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <utility>
+#include <cstdio>
 #include <chrono>
+#include <sys/resource.h>
 #ifdef MPI
 #include "_mpi.hxx"
 #endif
@@ -188,6 +190,42 @@ inline float measureDurationMarkedMpi(F fn, int N=1) {
 
 
 
+#pragma region MEASURE MEMORY
+/**
+ * Reset the peak resident set size of the process to its current resident set size.
+ * @returns success? (needs /proc/self/clear_refs, Linux)
+ */
+inline bool resetPeakResidentSetSize() {
+  FILE *f = fopen("/proc/self/clear_refs", "w");
+  if (!f) return false;
+  bool a = fputs("5", f)>=0;
+  return fclose(f)==0 && a;
+}
+
+
+/**
+ * Get the peak resident set size (memory usage) of the process, since the last reset.
+ * @returns peak resident set size in bytes
+ * @note Falls back to the peak over the lifetime of the process, if /proc/self/status is not available.
+ */
+inline size_t peakResidentSetSize() {
+  size_t a = 0;
+  if (FILE *f = fopen("/proc/self/status", "r")) {
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+      if (sscanf(line, "VmHWM: %zu kB", &a)==1) break;
+    fclose(f);
+    if (a) return a * 1024;
+  }
+  struct rusage r;
+  if (getrusage(RUSAGE_SELF, &r)!=0) return 0;
+  return size_t(r.ru_maxrss) * 1024;  // In kilobytes on Linux
+}
+#pragma endregion
+
+
+
+
 #pragma region RETRY
 /**
  * Call a function, retrying if it fails.
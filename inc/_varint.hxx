@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+
+
+
+
+#pragma region METHODS
+#pragma region VARINT
+/**
+ * Get the number of bytes needed to encode a number as a varint (LEB128).
+ * @param x number
+ * @returns number of bytes [1-10]
+ */
+inline int varintBytes(uint64_t x) {
+  int n = 1;
+  for (; x>=0x80; x>>=7)
+    ++n;
+  return n;
+}
+
+
+/**
+ * Encode a number as a varint (LEB128), 7 bits per byte, lowest bits first.
+ * @param a output bytes (updated)
+ * @param x number
+ * @returns pointer after the encoded bytes
+ */
+inline uint8_t* writeVarintW(uint8_t *a, uint64_t x) {
+  for (; x>=0x80; x>>=7)
+    *(a++) = uint8_t(x | 0x80);
+  *(a++) = uint8_t(x);
+  return a;
+}
+
+
+/**
+ * Decode a varint (LEB128) into a number.
+ * @param a decoded number (output)
+ * @param x input bytes
+ * @returns pointer after the decoded bytes
+ */
+inline const uint8_t* readVarintW(uint64_t& a, const uint8_t *x) {
+  uint64_t b = *(x++);
+  // Fast path for small numbers (most gaps of sorted neighbor lists).
+  if (b < 0x80) { a = b; return x; }
+  a = b & 0x7F;
+  for (int s=7;; s+=7) {
+    b  = *(x++);
+    a |= (b & 0x7F) << s;
+    if (b < 0x80) break;
+  }
+  return x;
+}
+#pragma endregion
+#pragma endregion
@@ -0,0 +1,179 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::string_view;
+using std::vector;
+using std::memcpy;
+using std::min;
+using std::max;
+
+
+
+
+#pragma region METHODS
+#pragma region RANDOM
+/**
+ * Get the i-th number of a counter-based random stream (splitmix64).
+ * Each number depends only on (seed, i), so generation does not depend on the number of threads.
+ * @param seed random seed
+ * @param i index in stream
+ * @returns random 64-bit number
+ */
+inline uint64_t randomCounter64(uint64_t seed, uint64_t i) {
+  uint64_t x = seed + (i+1) * 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+
+/**
+ * Get the i-th number of a counter-based random stream, as a real number in [0, 1).
+ * @param seed random seed
+ * @param i index in stream
+ * @returns random number in [0, 1)
+ */
+inline double randomCounterReal(uint64_t seed, uint64_t i) {
+  return (randomCounter64(seed, i) >> 11) * (1.0 / 9007199254740992.0);
+}
+#pragma endregion
+
+
+
+
+#pragma region GENERATE EDGE
+/**
+ * Generate the i-th edge of a uniform random graph.
+ * @param u source vertex id, 0-based (output)
+ * @param v target vertex id, 0-based (output)
+ * @param w edge weight [1-100] (output)
+ * @param i edge index
+ * @param n number of vertices
+ * @param seed random seed
+ */
+inline void generateUniformEdgeW(uint64_t& u, uint64_t& v, uint64_t& w, size_t i, size_t n, uint64_t seed) {
+  u = randomCounter64(seed, 4*i)   % n;
+  v = randomCounter64(seed, 4*i+1) % n;
+  w = randomCounter64(seed, 4*i+2) % 100 + 1;
+}
+
+
+/**
+ * Generate the i-th edge of an R-MAT graph.
+ * At each level of the adjacency matrix, a quadrant is picked with probabilities a, b, c, and 1-a-b-c.
+ * @param u source vertex id, 0-based (output)
+ * @param v target vertex id, 0-based (output)
+ * @param w edge weight [1-100] (output)
+ * @param i edge index
+ * @param n number of vertices
+ * @param a probability of top-left quadrant
+ * @param b probability of top-right quadrant
+ * @param c probability of bottom-left quadrant
+ * @param seed random seed
+ */
+inline void generateRmatEdgeW(uint64_t& u, uint64_t& v, uint64_t& w, size_t i, size_t n, double a, double b, double c, uint64_t seed) {
+  const int L = n>1? int(ceil(log2(double(n)))) : 0;  // Number of levels
+  const double ab = a + b, abc = a + b + c;
+  // Retry (with a different stream) if the edge falls outside the matrix.
+  for (uint64_t r=0;; ++r) {
+    uint64_t s = randomCounter64(seed, r);
+    u = 0; v = 0;
+    for (int l=0; l<L; ++l) {
+      double p = randomCounterReal(s, 64*i + l);
+      u = (u << 1) | (p >= ab);
+      v = (v << 1) | ((p >= a && p < ab) || p >= abc);
+    }
+    if (u<n && v<n) break;
+  }
+  w = randomCounter64(seed, 64*i + 63) % 100 + 1;
+}
+#pragma endregion
+
+
+
+
+#pragma region WRITE GENERATED GRAPH
+/**
+ * Write an unsigned number as decimal text [helper function].
+ * @param a output characters (updated)
+ * @param x number
+ * @returns pointer after the written characters
+ */
+inline char* writeGeneratedNumberW(char *a, uint64_t x) {
+  char b[20]; int n = 0;
+  do { b[n++] = char('0' + x % 10); x /= 10; } while (x);
+  while (n) *(a++) = b[--n];
+  return a;
+}
+
+
+/**
+ * Write a generated graph as an MTX file, or as an Edgelist file (without header), in parallel.
+ * Blocks of edges are generated and formatted by all threads, and then written in order.
+ * @tparam WEIGHTED write edge weights?
+ * @param pth output file path
+ * @param n number of vertices
+ * @param m number of edges
+ * @param mtx write MTX header?
+ * @param fe generate i-th edge (u, v, w, i), with 0-based vertex ids
+ * @returns success?
+ */
+template <bool WEIGHTED=false, class FE>
+inline bool writeGeneratedGraphOmp(const char *pth, size_t n, size_t m, bool mtx, FE fe) {
+  const size_t BLOCK = 1 << 15;  // Edges per block
+  const size_t LINE  = 3 * 21;   // Maximum characters per line
+  const int    T = omp_get_max_threads();
+  int fd = open(pth, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd<0) return false;
+  bool ok = true;
+  auto fw = [&](const char *x, size_t N) {
+    while (ok && N>0) {
+      ssize_t r = write(fd, x, N);
+      if (r<=0) { ok = false; break; }
+      x += r; N -= r;
+    }
+  };
+  // Write MTX header.
+  if (mtx) {
+    char h[256]; char *x = h;
+    string_view t = WEIGHTED? "%%MatrixMarket matrix coordinate integer general\n" : "%%MatrixMarket matrix coordinate pattern general\n";
+    memcpy(x, t.data(), t.size()); x += t.size();
+    x = writeGeneratedNumberW(x, n); *(x++) = ' ';
+    x = writeGeneratedNumberW(x, n); *(x++) = ' ';
+    x = writeGeneratedNumberW(x, m); *(x++) = '\n';
+    fw(h, x-h);
+  }
+  // Generate, format, and write edges, T blocks at a time.
+  vector<vector<char>> bufs(T, vector<char>(BLOCK * LINE));
+  vector<size_t> sizes(T);
+  for (size_t i=0; ok && i<m; i+=T*BLOCK) {
+    #pragma omp parallel for schedule(static, 1)
+    for (int t=0; t<T; ++t) {
+      size_t b = min(i + t*BLOCK, m);
+      size_t B = min(b + BLOCK, m);
+      char  *x = bufs[t].data();
+      for (size_t j=b; j<B; ++j) {
+        uint64_t u = 0, v = 0, w = 0;
+        fe(u, v, w, j);
+        x = writeGeneratedNumberW(x, u+1); *(x++) = ' ';
+        x = writeGeneratedNumberW(x, v+1);
+        if (WEIGHTED) { *(x++) = ' '; x = writeGeneratedNumberW(x, w); }
+        *(x++) = '\n';
+      }
+      sizes[t] = x - bufs[t].data();
+    }
+    for (int t=0; t<T; ++t)
+      fw(bufs[t].data(), sizes[t]);
+  }
+  ok = close(fd)==0 && ok;
+  return ok;
+}
+#pragma endregion
+#pragma endregion
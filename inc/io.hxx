@@ -1,16 +1,479 @@
 #pragma once
 #include <cstdint>
 #include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <type_traits>
 #include <string_view>
+#include <utility>
 #include <vector>
+#include <limits>
 #include <algorithm>
 
 using std::remove_reference_t;
+using std::numeric_limits;
 using std::string_view;
 using std::vector;
 using std::memcpy;
+using std::memset;
+using std::memcmp;
 using std::min;
+using std::max;
+using std::pair;
+using std::sort;
+using std::inplace_merge;
+using std::memmove;
+using std::count;
+using std::fill;
+using std::swap;
+
+
+
+
+#pragma region CLASSES
+/**
+ * Header of a binary CSR snapshot file.
+ * @note The header is followed by page-aligned offsets, edge keys, and edge values sections.
+ */
+struct CsrSnapshotHeader {
+  #pragma region CONSTANTS
+  public:
+  /** Magic bytes identifying a CSR snapshot. */
+  static constexpr char MAGIC[8] = {'G', 'V', 'E', 'L', 'C', 'S', 'R', '\0'};
+  /** Version of the snapshot layout. */
+  static constexpr uint32_t VERSION = 2;
+  /** Alignment of each section (page size). */
+  static constexpr uint32_t ALIGNMENT = 4096;
+  /** Flag indicating that edge values are present. */
+  static constexpr uint32_t WEIGHTED = 0x1;
+  /** Flag indicating that the outgoing edges of each vertex are sorted. */
+  static constexpr uint32_t SORTED   = 0x2;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Magic bytes. */
+  char     magic[8];
+  /** Layout version. */
+  uint32_t version;
+  /** Flags (weighted? sorted?). */
+  uint32_t flags;
+  /** Number of vertices. */
+  uint64_t order;
+  /** Number of edges. */
+  uint64_t size;
+  /** Size of vertex id type. */
+  uint32_t keyBytes;
+  /** Size of edge value type. */
+  uint32_t edgeValueBytes;
+  /** Size of offset type. */
+  uint32_t offsetBytes;
+  /** Alignment of each section. */
+  uint32_t alignment;
+  /** Start of offsets section. */
+  uint64_t offsetsStart;
+  /** Start of edge keys section. */
+  uint64_t edgeKeysStart;
+  /** Start of edge values section. */
+  uint64_t edgeValuesStart;
+  /** Total file size. */
+  uint64_t fileSize;
+  /** Checksum of header (with this field zero), and of offsets, edge keys, and edge values sections. */
+  uint64_t checksum;
+  #pragma endregion
+};
+
+
+
+/**
+ * Scratch space of a parallel Edgelist loader, bounded to O(M) in total.
+ * Edges are recorded in fixed-size chunks handed out from a shared pool, and
+ * each chunk is tagged with the partition (or bucket) it belongs to.
+ * @tparam K key type (vertex id)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ */
+template <class K=uint32_t, class E=None, class O=size_t>
+class EdgelistBuffer {
+  #pragma region TYPES
+  public:
+  /** Key type (vertex id). */
+  using key_type = K;
+  /** Edge value type (edge weight). */
+  using edge_value_type = E;
+  /** Offset type (edge offset). */
+  using offset_type = O;
+  #pragma endregion
+
+
+  #pragma region DATA
+  public:
+  /** Number of edges per chunk. */
+  size_t chunkSize = 0;
+  /** Number of chunks in the pool. */
+  size_t chunks = 0;
+  /** Number of chunks handed out. */
+  size_t used = 0;
+  /** Huge page mode of allocations (HUGE_PAGES_*). */
+  int huge = HUGE_PAGES_NONE;
+  /** Source vertices of the edges in each chunk. */
+  MappedPtr<K> sources;
+  /** Target vertices of the edges in each chunk. */
+  MappedPtr<K> targets;
+  /** Edge weights of the edges in each chunk, if weighted. */
+  MappedPtr<E> weights;
+  /** Number of edges recorded in each chunk. */
+  vector<size_t> counts;
+  /** Tag (partition) of each chunk. */
+  vector<int> tags;
+  /** Per-partition CSR offsets (for conversion to CSR). */
+  vector<MappedPtr<O>> poffsets;
+  /** Per-partition CSR edge keys (for conversion to CSR). */
+  vector<MappedPtr<K>> pedgeKeys;
+  /** Per-partition CSR edge values (for conversion to CSR). */
+  vector<MappedPtr<E>> pedgeValues;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Get the maximum number of edges that can be recorded.
+   * @returns number of edges
+   */
+  inline size_t capacity() const noexcept {
+    return chunks * chunkSize;
+  }
+
+  /**
+   * Get the number of edges recorded.
+   * @returns number of edges
+   */
+  inline size_t size() const noexcept {
+    size_t a = 0;
+    for (size_t c=0; c<used; ++c)
+      a += counts[c];
+    return a;
+  }
+
+  /**
+   * Get the number of scratch bytes reserved (peak usage).
+   * @returns number of bytes
+   */
+  inline size_t bytes() const noexcept {
+    size_t a = sources.size() + targets.size() + weights.size();
+    a += counts.capacity() * sizeof(size_t) + tags.capacity() * sizeof(int);
+    for (const auto& x : poffsets)    a += x.size();
+    for (const auto& x : pedgeKeys)   a += x.size();
+    for (const auto& x : pedgeValues) a += x.size();
+    return a;
+  }
+
+  /**
+   * Hand out a free chunk (thread-safe).
+   * @param tag tag (partition) of the chunk
+   * @returns chunk index, or -1 if the pool is exhausted
+   */
+  inline size_t acquire(int tag) noexcept {
+    size_t c = 0;
+    #pragma omp atomic capture
+    c = used++;
+    if (c>=chunks) return size_t(-1);
+    counts[c] = 0;
+    tags[c]   = tag;
+    return c;
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Allocate scratch space for a parallel Edgelist loader.
+   * @param capacity maximum number of edges to record
+   * @param weighted record edge weights?
+   * @param slack number of extra chunks (one partially filled chunk per thread, per tag)
+   * @param chunkSize number of edges per chunk
+   * @param huge huge page mode of allocations (HUGE_PAGES_*)
+   * @note Chunks are not touched here, so their pages are placed by the threads that fill them.
+   */
+  EdgelistBuffer(size_t capacity, bool weighted, size_t slack, size_t chunkSize=16384, int huge=HUGE_PAGES_NONE) :
+  chunkSize(chunkSize), chunks((capacity + chunkSize-1) / chunkSize + slack), huge(huge),
+  sources(chunks * chunkSize * sizeof(K), huge),
+  targets(chunks * chunkSize * sizeof(K), huge),
+  weights(weighted? chunks * chunkSize * sizeof(E) : 0, huge),
+  counts(chunks), tags(chunks) {
+    if (chunks>0 && (!sources || !targets || (weighted && !weights))) throw std::bad_alloc();
+  }
+  #pragma endregion
+};
+
+
+
+/**
+ * Per-thread writer that appends edges to the chunks of an EdgelistBuffer.
+ * @tparam K key type (vertex id)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ */
+template <class K=uint32_t, class E=None, class O=size_t>
+class EdgelistBufferWriter {
+  #pragma region DATA
+  public:
+  /** Scratch buffer to write to. */
+  EdgelistBuffer<K, E, O>& buf;
+  /** Tag (partition) of the chunks acquired. */
+  int tag;
+  /** Current chunk, or -1 if none. */
+  size_t c = size_t(-1);
+  /** Number of edges in current chunk. */
+  size_t i = 0;
+  /** Source vertices of current chunk. */
+  K *sources = nullptr;
+  /** Target vertices of current chunk. */
+  K *targets = nullptr;
+  /** Edge weights of current chunk. */
+  E *weights = nullptr;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Record the number of edges in the current chunk.
+   */
+  inline void flush() noexcept {
+    if (c!=size_t(-1)) buf.counts[c] = i;
+  }
+
+  /**
+   * Switch to a new chunk.
+   * @tparam WEIGHTED is graph weighted?
+   * @returns success? (false if the buffer is exhausted)
+   */
+  template <bool WEIGHTED=false>
+  inline bool next() noexcept {
+    const size_t C = buf.chunkSize;
+    flush();
+    c = buf.acquire(tag); i = 0;
+    if (c==size_t(-1)) return false;
+    sources = buf.sources + c*C;
+    targets = buf.targets + c*C;
+    if constexpr (WEIGHTED) weights = buf.weights + c*C;
+    return true;
+  }
+
+  /**
+   * Append an edge.
+   * @tparam WEIGHTED is graph weighted?
+   * @param u source vertex id
+   * @param v target vertex id
+   * @param w edge weight
+   * @returns success? (false if the buffer is exhausted)
+   */
+  template <bool WEIGHTED=false>
+  inline bool push(K u, K v, E w) noexcept {
+    if (c==size_t(-1) || i==buf.chunkSize) {
+      if (!next<WEIGHTED>()) return false;
+    }
+    sources[i] = u;
+    targets[i] = v;
+    if constexpr (WEIGHTED) weights[i] = w;
+    ++i;
+    return true;
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Create a writer for an EdgelistBuffer.
+   * @param buf scratch buffer to write to
+   * @param tag tag (partition) of the chunks acquired
+   */
+  EdgelistBufferWriter(EdgelistBuffer<K, E, O>& buf, int tag) :
+  buf(buf), tag(tag) {}
+  #pragma endregion
+};
+
+
+
+/**
+ * A file (or pipe, or stdin) read in fixed-size chunks into a ring of reusable
+ * buffers with read(). The partial line at the end of a chunk is carried over
+ * to the start of the next chunk.
+ */
+class StreamedFile {
+  #pragma region DATA
+  public:
+  /** File descriptor (not owned). */
+  int fd = -1;
+  /** Number of bytes read per chunk. */
+  size_t chunkSize = 0;
+  /** Maximum length of a partial line carried over. */
+  size_t carrySize = 0;
+  /** Number of buffers in the ring. */
+  size_t slots = 0;
+  /** Memory for all buffers, each with a carry area followed by a chunk area. */
+  MappedPtr<char> pool;
+  /** Begin of valid data in each buffer. */
+  vector<size_t> begins;
+  /** End of valid data in each buffer. */
+  vector<size_t> ends;
+  /** Does each buffer hold the last chunk? */
+  vector<bool> lasts;
+  /** Current buffer. */
+  size_t current = 0;
+  /** Total number of bytes read. */
+  size_t bytesRead = 0;
+  /** Time spent reading (ms). */
+  float readTime = 0;
+  /** Time spent parsing (ms), recorded by the loader. */
+  float parseTime = 0;
+  #pragma endregion
+
+
+  #pragma region METHODS
+  public:
+  /**
+   * Get the memory of a buffer.
+   * @param s buffer index
+   * @returns buffer memory
+   */
+  inline char* slot(size_t s) const noexcept {
+    return pool.data() + s * (carrySize + chunkSize);
+  }
+
+  /**
+   * Get all data in the current buffer, including any partial line at the end.
+   * @returns current data
+   */
+  inline string_view data() const noexcept {
+    size_t s = current;
+    return string_view(slot(s) + begins[s], ends[s] - begins[s]);
+  }
+
+  /**
+   * Get the complete lines in the current buffer.
+   * @returns current lines (all data, if last chunk)
+   */
+  inline string_view lines() const noexcept {
+    string_view x = data();
+    if (lasts[current]) return x;
+    size_t n = x.rfind('\n');
+    return n==string_view::npos? string_view() : x.substr(0, n+1);
+  }
+
+  /**
+   * Is the current buffer the last chunk?
+   * @returns last chunk?
+   */
+  inline bool last() const noexcept {
+    return lasts[current];
+  }
+
+  /**
+   * Is the partial line at the end of the current buffer too long to carry over?
+   * @returns carry overflow?
+   */
+  inline bool carryOverflow() const noexcept {
+    return data().size() - lines().size() > carrySize;
+  }
+
+  /**
+   * Skip bytes at the start of current buffer (e.g. a header).
+   * @param n number of bytes to skip
+   */
+  inline void skip(size_t n) noexcept {
+    begins[current] = min(begins[current] + n, ends[current]);
+  }
+
+  /**
+   * Fill a buffer with a carried over partial line, and the next chunk of the file.
+   * @param s buffer index
+   * @param carry partial line to carry over
+   * @returns success?
+   */
+  inline bool fill(size_t s, string_view carry) {
+    if (carry.size() > carrySize) return false;
+    auto t0 = timeNow();
+    char  *x = slot(s);
+    size_t n = 0;
+    if (!carry.empty()) memcpy(x + carrySize - carry.size(), carry.data(), carry.size());
+    // Read until the chunk is full, or the file ends.
+    bool eof = false;
+    while (n < chunkSize) {
+      ssize_t r = read(fd, x + carrySize + n, chunkSize - n);
+      if (r<0)  return false;
+      if (r==0) { eof = true; break; }
+      n += r;
+    }
+    begins[s] = carrySize - carry.size();
+    ends[s]   = carrySize + n;
+    lasts[s]  = eof;
+    bytesRead += n;
+    readTime  += duration(t0);
+    return true;
+  }
+
+  /**
+   * Read the next chunk into the next buffer, carrying over the partial line in current buffer.
+   * @returns success?
+   */
+  inline bool prefetch() {
+    string_view x = data(), y = lines();
+    return fill((current+1) % slots, x.substr(y.size()));
+  }
+
+  /**
+   * Switch to the next buffer (must be prefetched).
+   */
+  inline void advance() noexcept {
+    current = (current+1) % slots;
+  }
+  #pragma endregion
+
+
+  #pragma region CONSTRUCTORS
+  public:
+  /**
+   * Start reading a file in chunks, and read the first chunk.
+   * @param fd file descriptor (e.g. 0 for stdin)
+   * @param chunkSize number of bytes read per chunk
+   * @param slots number of buffers in the ring (at least 2)
+   * @param carrySize maximum length of a partial line carried over
+   */
+  StreamedFile(int fd, size_t chunkSize=64*1024*1024, size_t slots=2, size_t carrySize=1024*1024) :
+  fd(fd), chunkSize(chunkSize), carrySize(carrySize), slots(max(slots, size_t(2))),
+  pool(max(slots, size_t(2)) * (carrySize + chunkSize)),
+  begins(this->slots), ends(this->slots), lasts(this->slots, true) {
+    if (fd<0 || !pool.data() || !fill(0, string_view())) lasts[0] = true;
+  }
+  #pragma endregion
+};
+
+
+
+/**
+ * Time taken by each phase of converting an Edgelist to CSR (ms).
+ */
+struct CsrPhaseTimes {
+  /** Computing offsets (prefix sums of degrees). */
+  float scan    = 0;
+  /** Merging per-partition degrees into global degrees. */
+  float merge   = 0;
+  /** Scattering edges into (per-partition) CSR. */
+  float scatter = 0;
+  /** Combining per-partition CSR into global CSR. */
+  float combine = 0;
+  /** Parsing Edgelist (if done by the converter). */
+  float parse   = 0;
+  /** Mapping sparse vertex ids to dense ids, and relabeling edges. */
+  float relabel = 0;
+};
+#pragma endregion
 
 
 
@@ -96,6 +559,7 @@ inline size_t readMtxFormatHeaderW(bool& symmetric, size_t& rows, size_t& cols,
  * @param data input file data
  * @param symmetric is graph symmetric?
  * @param fb on body line (u, v, w)
+ * @note Vertex ids are parsed as 64-bit unsigned integers, with overflow detection.
  */
 template <bool WEIGHTED=false, int BASE=1, class FB>
 inline void readEdgelistFormatDoChecked(string_view data, bool symmetric, FB fb) {
@@ -107,14 +571,16 @@ inline void readEdgelistFormatDoChecked(string_view data, bool symmetric, FB fb)
     it = findNextNonBlank(it, ie, fu);
     if (it==ie || *it=='%' || *it=='#' || isNewline(*it)) continue;
     // Read u, v, w (if weighted).
-    int64_t u = 0, v = 0; double w = 1; auto il = it;
+    uint64_t u = 0, v = 0; double w = 1; auto il = it;
     it = readNumberW<true>(u, it, ie, fu, fw);  // Source vertex
     it = readNumberW<true>(v, it, ie, fu, fw);  // Target vertex
     if constexpr (WEIGHTED) {
       it = readNumberW<true>(w, it, ie, fu, fw);  // Edge weight
     }
-    if constexpr (BASE) { --u; --v; }  // Convert to zero-based
-    if (u<0 || v<0) throw FormatError("Invalid Edgelist body (negative vertex-id)", il);
+    if constexpr (BASE) {
+      if (u==0 || v==0) throw FormatError("Invalid Edgelist body (zero vertex-id, with 1-based ids)", il);
+      --u; --v;  // Convert to zero-based
+    }
     fb(u, v, w);
     if (symmetric && u!=v) fb(v, u, w);
   }
@@ -151,6 +617,141 @@ inline void readEdgelistFormatDoUnchecked(string_view data, bool symmetric, FB f
 }
 
 
+/**
+ * Read an EdgeList format file, classifying 64 characters at a time (crazy frog version, SIMD).
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @tparam LEVEL SIMD level of digit classifier
+ * @param data input file data
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w)
+ * @note Produces exactly the same edges as readEdgelistFormatDoUnchecked().
+ * @note Call through readEdgelistFormatDoLevel(), so that the classifier is inlined with its target enabled.
+ */
+template <bool WEIGHTED=false, int BASE=1, int LEVEL=SIMD_SCALAR, class FB>
+inline void readEdgelistFormatDoSimd(string_view data, bool symmetric, FB fb) {
+  const char  *x = data.data();
+  const size_t N = data.size();
+  size_t   wi = size_t(-1);  // Begin of classified window [wi, wi+64)
+  uint64_t wm = 0;           // Digit mask of classified window
+  // Find the next digit (or non-digit), classifying a new window when needed.
+  auto findNext = [&](size_t i, bool digit) {
+    while (true) {
+      if (i<wi || i-wi>=64) {
+        if (N-i < 64) return size_t((digit? findNextDigit(x+i, x+N) : findNextNonDigit(x+i, x+N)) - x);
+        wi = i; wm = digitMask64<LEVEL>(x+i);
+      }
+      uint64_t m = (digit? wm : ~wm) >> (i-wi);
+      if (m) return i + __builtin_ctzll(m);
+      i = wi + 64;
+    }
+  };
+  // Parse a run of digits, 8 at a time.
+  auto parseRun = [&](size_t i, size_t I) {
+    size_t n = I-i;
+    if (n==0) return uint64_t();
+    if (n<=8  && i+8 <=N) return parseDigitsSwar(x+i, int(n));
+    if (n<=16 && i+16<=N) return parseDigitsSwar(x+i, int(n-8)) * uint64_t(100000000) + parseDigitsSwar(x+I-8, 8);
+    uint64_t a = 0;
+    parseWholeNumberW(a, x+i, x+I);
+    return a;
+  };
+  size_t i = 0;
+  while (true) {
+    // Read u, v, w (if weighted).
+    uint64_t u = 0, v = 0; double w = 1;
+    i = findNext(i, true);
+    if (i==N) break;  // No more lines
+    size_t I = findNext(i, false);
+    u = parseRun(i, I);  // Source vertex
+    i = findNext(I, true);
+    I = findNext(i, false);
+    v = parseRun(i, I);  // Target vertex
+    i = I;
+    if constexpr (WEIGHTED) {
+      i = findNext(i, true);
+      i = parseFloatW(w, x+i, x+N) - x;  // Edge weight
+    }
+    if constexpr (BASE) { --u; --v; }  // Convert to zero-based
+    fb(u, v, w);
+    if (symmetric && u!=v) fb(v, u, w);
+  }
+}
+
+
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Read an EdgeList format file, classifying 64 characters at a time with SSE2 [helper function].
+ * The whole scan loop is compiled for the target (flatten), so the classifier is inlined.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @param data input file data
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w)
+ */
+template <bool WEIGHTED=false, int BASE=1, class FB>
+__attribute__((target("sse2"), flatten))
+inline void readEdgelistFormatDoSse2(string_view data, bool symmetric, FB fb) {
+  readEdgelistFormatDoSimd<WEIGHTED, BASE, SIMD_SSE2>(data, symmetric, fb);
+}
+
+
+/**
+ * Read an EdgeList format file, classifying 64 characters at a time with AVX2 [helper function].
+ * The whole scan loop is compiled for the target (flatten), so the classifier is inlined.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @param data input file data
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w)
+ */
+template <bool WEIGHTED=false, int BASE=1, class FB>
+__attribute__((target("avx2"), flatten))
+inline void readEdgelistFormatDoAvx2(string_view data, bool symmetric, FB fb) {
+  readEdgelistFormatDoSimd<WEIGHTED, BASE, SIMD_AVX2>(data, symmetric, fb);
+}
+
+
+/**
+ * Read an EdgeList format file, classifying 64 characters at a time with AVX-512 (BW) [helper function].
+ * The whole scan loop is compiled for the target (flatten), so the classifier is inlined.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @param data input file data
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w)
+ */
+template <bool WEIGHTED=false, int BASE=1, class FB>
+__attribute__((target("avx512f,avx512bw"), flatten))
+inline void readEdgelistFormatDoAvx512(string_view data, bool symmetric, FB fb) {
+  readEdgelistFormatDoSimd<WEIGHTED, BASE, SIMD_AVX512>(data, symmetric, fb);
+}
+#endif
+
+
+/**
+ * Read an EdgeList format file, at a SIMD level chosen at runtime (dispatched once, outside the scan loop).
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @param level SIMD level (must be supported)
+ * @param data input file data
+ * @param symmetric is graph symmetric?
+ * @param fb on body line (u, v, w)
+ */
+template <bool WEIGHTED=false, int BASE=1, class FB>
+inline void readEdgelistFormatDoLevel(int level, string_view data, bool symmetric, FB fb) {
+  switch (level) {
+#if defined(__x86_64__) || defined(__i386__)
+    case SIMD_SSE2:   readEdgelistFormatDoSse2  <WEIGHTED, BASE>(data, symmetric, fb); break;
+    case SIMD_AVX2:   readEdgelistFormatDoAvx2  <WEIGHTED, BASE>(data, symmetric, fb); break;
+    case SIMD_AVX512: readEdgelistFormatDoAvx512<WEIGHTED, BASE>(data, symmetric, fb); break;
+#endif
+    default:          readEdgelistFormatDoUnchecked<WEIGHTED, BASE>(data, symmetric, fb); break;
+  }
+}
+
+
 /**
  * Read an EdgeList format file.
  * @tparam WEIGHTED is graph weighted?
@@ -159,11 +760,12 @@ inline void readEdgelistFormatDoUnchecked(string_view data, bool symmetric, FB f
  * @param data input file data (updated)
  * @param symmetric is graph symmetric?
  * @param fb on body line (u, v, w)
+ * @note Unchecked reading uses the highest SIMD level supported by the CPU.
  */
 template <bool WEIGHTED=false, int BASE=1, bool CHECK=false, class FB>
 inline void readEdgelistFormatDo(string_view data, bool symmetric, FB fb) {
   if constexpr (CHECK) readEdgelistFormatDoChecked<WEIGHTED, BASE>(data, symmetric, fb);
-  else readEdgelistFormatDoUnchecked<WEIGHTED, BASE>(data, symmetric, fb);
+  else readEdgelistFormatDoLevel<WEIGHTED, BASE>(simdLevel(), data, symmetric, fb);
 }
 
 
@@ -262,6 +864,245 @@ inline vector<size_t> readEdgelistFormatToListsOmpU(IIK degrees, IIK sources, II
   if (CHECK && !err.empty()) throw err;
   return is;
 }
+
+
+/**
+ * Read an EdgeList format file, and record the edges into a bounded scratch buffer, and vertex degrees.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @tparam CHECK check for error?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param degrees per-partition vertex degrees (updated)
+ * @param buf scratch buffer for edges, chunks tagged by partition (updated)
+ * @param data input file data
+ * @param symmetric is graph symmetric (reverse edges are counted, but not stored)
+ */
+template <bool WEIGHTED=false, int BASE=1, bool CHECK=false, int PARTITIONS=4, class IIK, class K, class E, class O>
+inline void readEdgelistFormatToBufferOmpU(IIK degrees, EdgelistBuffer<K, E, O>& buf, string_view data, bool symmetric) {
+  const size_t DATA  = data.size();
+  const size_t BLOCK = 256 * 1024;  // Characters per block (256KB)
+  FormatError err;    // Common error
+  bool full = false;  // Scratch buffer exhausted?
+  // Process a grid in parallel with dynamic scheduling.
+  #pragma omp parallel shared(err, full)
+  {
+    const int t = omp_get_thread_num();
+    const int p = t % PARTITIONS;
+    EdgelistBufferWriter<K, E, O> wr(buf, p);
+    #pragma omp for schedule(dynamic) nowait
+    for (size_t b=0; b<DATA; b+=BLOCK) {
+      bool stop = false;
+      #pragma omp atomic read
+      stop = full;
+      if (stop || (CHECK && !err.empty())) continue;
+      // Read a block of data, and process it.
+      string_view bdata = readEdgelistFormatBlock(data, b, BLOCK);
+      auto fb = [&](auto u, auto v, auto w) {
+        if (!wr.template push<WEIGHTED>(K(u), K(v), E(w))) {
+          #pragma omp atomic write
+          full = true;
+          return;
+        }
+        #pragma omp atomic
+        ++degrees[p][u];
+        if (symmetric && u!=v) {
+          #pragma omp atomic
+          ++degrees[p][v];
+        }
+      };
+      if constexpr (CHECK) {
+        try { readEdgelistFormatDo<WEIGHTED, BASE, true>(bdata, false, fb); }
+        catch (const FormatError& e) {
+          #pragma omp critical
+          if (err.empty()) err = e;
+        }
+      }
+      else readEdgelistFormatDo<WEIGHTED, BASE>(bdata, false, fb);
+    }
+    // Update size of last chunk.
+    wr.flush();
+  }
+  buf.used = min(buf.used, buf.chunks);
+  // Throw error if any.
+  if (CHECK && !err.empty()) throw err;
+  if (full) throw FormatError("Edgelist exceeds scratch buffer capacity");
+}
+
+
+/**
+ * Read an EdgeList format file from a stream in chunks, and record the edges into a bounded scratch buffer, and vertex degrees.
+ * While worker threads parse the current chunk, the master thread reads the next chunk.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @tparam CHECK check for error?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param degrees per-partition vertex degrees (updated)
+ * @param buf scratch buffer for edges, chunks tagged by partition (updated)
+ * @param stream chunked file, positioned at the first edge (updated)
+ * @param symmetric is graph symmetric (reverse edges are counted, but not stored)
+ */
+template <bool WEIGHTED=false, int BASE=1, bool CHECK=false, int PARTITIONS=4, class IIK, class K, class E, class O>
+inline void readEdgelistFormatStreamToBufferOmpU(IIK degrees, EdgelistBuffer<K, E, O>& buf, StreamedFile& stream, bool symmetric) {
+  const size_t BLOCK = 256 * 1024;  // Characters per block (256KB)
+  FormatError err;     // Common error
+  bool full = false;   // Scratch buffer exhausted?
+  bool done = false;   // All chunks processed?
+  float busy = 0;      // Parse time of slowest thread, in current chunk
+  string_view data = stream.lines();
+  #pragma omp parallel shared(err, full, done, busy, data)
+  {
+    const int t = omp_get_thread_num();
+    const int p = t % PARTITIONS;
+    EdgelistBufferWriter<K, E, O> wr(buf, p);
+    while (true) {
+      float tbusy = 0;  // Parse time of this thread, in current chunk
+      const size_t DATA = data.size();
+      // Read the next chunk, while others parse the current one.
+      #pragma omp master
+      if (!stream.last() && !stream.prefetch()) {
+        const char *msg = stream.carryOverflow()? "Edgelist line exceeds stream carry limit (carrySize, 1MB by default)" : "Failed to read stream";
+        #pragma omp critical
+        if (err.empty()) err = FormatError(msg);
+      }
+      #pragma omp for schedule(dynamic) nowait
+      for (size_t b=0; b<DATA; b+=BLOCK) {
+        bool stop = false;
+        #pragma omp atomic read
+        stop = full;
+        if (stop || (CHECK && !err.empty())) continue;
+        auto t0 = timeNow();
+        // Read a block of data, and process it.
+        string_view bdata = readEdgelistFormatBlock(data, b, BLOCK);
+        auto fb = [&](auto u, auto v, auto w) {
+          if (!wr.template push<WEIGHTED>(K(u), K(v), E(w))) {
+            #pragma omp atomic write
+            full = true;
+            return;
+          }
+          #pragma omp atomic
+          ++degrees[p][u];
+          if (symmetric && u!=v) {
+            #pragma omp atomic
+            ++degrees[p][v];
+          }
+        };
+        if constexpr (CHECK) {
+          try { readEdgelistFormatDo<WEIGHTED, BASE, true>(bdata, false, fb); }
+          catch (const FormatError& e) {
+            #pragma omp critical
+            if (err.empty()) err = e;
+          }
+        }
+        else readEdgelistFormatDo<WEIGHTED, BASE>(bdata, false, fb);
+        tbusy += duration(t0);
+      }
+      #pragma omp critical
+      busy = max(busy, tbusy);
+      #pragma omp barrier
+      // Switch to the next chunk.
+      #pragma omp single
+      {
+        stream.parseTime += busy; busy = 0;
+        if (stream.last() || full || !err.empty()) done = true;
+        else { stream.advance(); data = stream.lines(); }
+      }
+      if (done) break;
+    }
+    // Update size of last chunk.
+    wr.flush();
+  }
+  buf.used = min(buf.used, buf.chunks);
+  // Throw error if any.
+  if (!err.empty()) throw err;
+  if (full) throw FormatError("Edgelist exceeds scratch buffer capacity");
+}
+
+
+/**
+ * Get the number of vertices per range, for atomic-free CSR construction.
+ * Ranges are sized to keep the offsets of a range in (L2) cache, with at least
+ * 4 ranges per thread for load balancing, and at most 16.
+ * @tparam O offset type
+ * @param rows number of rows/vertices
+ * @param threads number of threads
+ * @param cache cache size per thread, in bytes
+ * @returns vertices per range
+ */
+template <class O=size_t>
+inline size_t edgelistRangeSize(size_t rows, int threads, size_t cache=512*1024) {
+  const size_t RMIN = 4  * size_t(threads);
+  const size_t RMAX = 16 * size_t(threads);
+  size_t R = (rows * sizeof(O) + cache-1) / cache;
+  R = max(RMIN, min(R, RMAX));
+  return max((rows + R-1) / R, size_t(1));
+}
+
+
+/**
+ * Read an EdgeList format file, and radix-partition the edges by source vertex range into a bounded scratch buffer.
+ * Each thread appends to its own chunk per range, so no atomics are needed per edge.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam BASE base vertex id (0 or 1)
+ * @tparam CHECK check for error?
+ * @param buf scratch buffer for edges, chunks tagged by range (updated)
+ * @param data input file data
+ * @param symmetric is graph symmetric
+ * @param rows number of rows/vertices
+ * @param range number of vertices per range
+ * @note The buffer needs a slack of (threads * ranges) chunks, and room for reverse edges if symmetric.
+ * @note Source vertex-ids are always checked against rows, as they select the range.
+ */
+template <bool WEIGHTED=false, int BASE=1, bool CHECK=false, class K, class E, class O>
+inline void readEdgelistFormatToRangesOmpU(EdgelistBuffer<K, E, O>& buf, string_view data, bool symmetric, size_t rows, size_t range) {
+  const size_t DATA  = data.size();
+  const size_t BLOCK = 256 * 1024;  // Characters per block (256KB)
+  const size_t R     = max((rows + range-1) / range, size_t(1));
+  FormatError err;    // Common error
+  bool full = false;  // Scratch buffer exhausted?
+  // Process a grid in parallel with dynamic scheduling.
+  #pragma omp parallel shared(err, full)
+  {
+    vector<EdgelistBufferWriter<K, E, O>> ws;
+    ws.reserve(R);
+    for (size_t r=0; r<R; ++r)
+      ws.emplace_back(buf, int(r));
+    #pragma omp for schedule(dynamic) nowait
+    for (size_t b=0; b<DATA; b+=BLOCK) {
+      bool stop = false;
+      #pragma omp atomic read
+      stop = full;
+      if (stop || (CHECK && !err.empty())) continue;
+      // Read a block of data, and process it.
+      string_view bdata = readEdgelistFormatBlock(data, b, BLOCK);
+      auto fb = [&](auto u, auto v, auto w) {
+        if (size_t(u)>=rows) {
+          #pragma omp critical
+          if (err.empty()) err = FormatError("Invalid Edgelist body (vertex-id exceeds number of rows)");
+          return;
+        }
+        if (!ws[u / range].template push<WEIGHTED>(K(u), K(v), E(w))) {
+          #pragma omp atomic write
+          full = true;
+        }
+      };
+      if constexpr (CHECK) {
+        try { readEdgelistFormatDo<WEIGHTED, BASE, true>(bdata, symmetric, fb); }
+        catch (const FormatError& e) {
+          #pragma omp critical
+          if (err.empty()) err = e;
+        }
+      }
+      else readEdgelistFormatDo<WEIGHTED, BASE>(bdata, symmetric, fb);
+    }
+    // Update size of last chunks.
+    for (auto& w : ws)
+      w.flush();
+  }
+  buf.used = min(buf.used, buf.chunks);
+  // Throw error if any.
+  if (!err.empty()) throw err;
+  if (full) throw FormatError("Edgelist exceeds scratch buffer capacity");
+}
 #endif
 #pragma endregion
 
@@ -299,7 +1140,7 @@ inline void convertEdgelistToCsrListsW(IO offsets, IK edgeKeys, IE edgeValues, I
 
 
 /**
- * Convert Edgelist format to CSR format.
+ * Convert Edgelist format to CSR format, with edges supplied by a parallel iterator [helper function].
  * @tparam WEIGHTED is graph weighted?
  * @tparam PARTITIONS number of partitions for vertex degrees
  * @param offsets CSR offsets (output)
@@ -308,40 +1149,41 @@ inline void convertEdgelistToCsrListsW(IO offsets, IK edgeKeys, IE edgeValues, I
  * @param poffsets per-partition CSR offsets (output)
  * @param pedgeKeys per-partition CSR edge keys (output)
  * @param pedgeValues per-partition CSR edge values (output)
- * @param degrees per-partition vertex degrees
- * @param sources per-thread source vertices
- * @param targets per-thread target vertices
- * @param weights per-thread edge weights
- * @param counts per-thread number of edges read
+ * @param degrees per-partition vertex degrees (updated)
  * @param rows number of rows/vertices
+ * @param fe iterate over edges in parallel (fp(partition, u, v, w))
+ * @param times time taken by each phase (updated, optional)
  */
-template <bool WEIGHTED=false, int PARTITIONS=4, class IO, class IK, class IE, class IIO, class IIK, class IIE>
-inline void convertEdgelistToCsrListsOmpW(IO offsets, IK edgeKeys, IE edgeValues, IIO poffsets, IIK pedgeKeys, IIE pedgeValues, IIK degrees, IIK sources, IIK targets, IIE weights, const vector<size_t>& counts, size_t rows) {
+template <bool WEIGHTED=false, int PARTITIONS=4, class IO, class IK, class IE, class IIO, class IIK, class IIE, class IID, class FE>
+inline void convertEdgelistToCsrDoOmpW(IO offsets, IK edgeKeys, IE edgeValues, IIO poffsets, IIK pedgeKeys, IIE pedgeValues, IID degrees, size_t rows, FE fe, CsrPhaseTimes *times=nullptr) {
   using O = remove_reference_t<decltype(poffsets[0][0])>;  // offsets[0][0]
   int   T = omp_get_max_threads();
-  vector<size_t> buf(T);
+  vector<O> buf(T);
+  auto t0 = timeNow();
+  auto fm = [&](float& a) { auto t1 = timeNow(); a += duration(t0, t1); t0 = t1; };
   if (PARTITIONS==1) {
     // Compute shifted global offsets at offsets.
     offsets[0] = O();
     exclusiveScanOmpW(offsets+1, buf.data(), degrees[0], rows);
+    if (times) fm(times->scan);
     // Populate global CSR at edgeKeys[0] and edgeValues[0].
-    #pragma omp parallel
-    {
-      int t = omp_get_thread_num();
-      size_t I = counts[t];
-      for (size_t i=0; i<I; ++i) {
-        size_t u = sources[t][i];
-        size_t v = targets[t][i];
-        size_t j = 0;
-        #pragma omp atomic capture
-        j = offsets[u+1]++;
-        edgeKeys[j] = v;
-        if constexpr (WEIGHTED) edgeValues[j] = weights[t][i];
-      }
-    }
+    fe([&](int, size_t u, size_t v, auto w) {
+      size_t j = 0;
+      #pragma omp atomic capture
+      j = offsets[u+1]++;
+      edgeKeys[j] = v;
+      if constexpr (WEIGHTED) edgeValues[j] = w;
+    });
+    if (times) fm(times->scatter);
     return;
   }
-  // Compute global degrees at degrees[0].
+  // Compute per-partition shifted offsets at offsets[p].
+  for (int p=0; p<PARTITIONS; ++p) {
+    poffsets[p][0] = O();
+    exclusiveScanOmpW(poffsets[p]+1, buf.data(), degrees[p], rows);
+  }
+  if (times) fm(times->scan);
+  // Compute global degrees at degrees[0] (after per-partition offsets, which need partition degrees).
   #pragma omp parallel for schedule(static, 2048)
   for (size_t u=0; u<rows; ++u) {
     if (PARTITIONS==1) {}
@@ -353,30 +1195,20 @@ inline void convertEdgelistToCsrListsOmpW(IO offsets, IK edgeKeys, IE edgeValues
         degrees[0][u] += degrees[t][u];
     }
   }
-  // Compute per-partition shifted offsets at offsets[p].
-  for (int p=0; p<PARTITIONS; ++p) {
-    poffsets[p][0] = O();
-    exclusiveScanOmpW(poffsets[p]+1, buf.data(), degrees[p], rows);
-  }
+  if (times) fm(times->merge);
   // Populate per-partition CSR at edgeKeys[p] and edgeValues[p].
-  #pragma omp parallel
-  {
-    int t = omp_get_thread_num();
-    size_t I = counts[t];
-    for (size_t i=0; i<I; ++i) {
-      const int p = t % PARTITIONS;
-      size_t u = sources[t][i];
-      size_t v = targets[t][i];
-      size_t j = 0;
-      #pragma omp atomic capture
-      j = poffsets[p][u+1]++;
-      pedgeKeys[p][j] = v;
-      if constexpr (WEIGHTED) pedgeValues[p][j] = weights[t][i];
-    }
-  }
+  fe([&](int p, size_t u, size_t v, auto w) {
+    size_t j = 0;
+    #pragma omp atomic capture
+    j = poffsets[p][u+1]++;
+    pedgeKeys[p][j] = v;
+    if constexpr (WEIGHTED) pedgeValues[p][j] = w;
+  });
+  if (times) fm(times->scatter);
   // Compute global offsets.
   offsets[0] = O();
   exclusiveScanOmpW(&offsets[0]+1, &buf[0], &degrees[0][0], rows);
+  if (times) fm(times->scan);
   // Combine per-partition CSR format.
   #pragma omp parallel for schedule(dynamic, 2048)
   for (size_t u=0; u<rows; ++u) {
@@ -391,6 +1223,964 @@ inline void convertEdgelistToCsrListsOmpW(IO offsets, IK edgeKeys, IE edgeValues
     }
     offsets[u+1] = j;
   }
+  if (times) fm(times->combine);
+}
+
+
+/**
+ * Convert Edgelist format to CSR format.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param offsets CSR offsets (output)
+ * @param edgeKeys CSR edge keys (output)
+ * @param edgeValues CSR edge values (output)
+ * @param poffsets per-partition CSR offsets (output)
+ * @param pedgeKeys per-partition CSR edge keys (output)
+ * @param pedgeValues per-partition CSR edge values (output)
+ * @param degrees per-partition vertex degrees
+ * @param sources per-thread source vertices
+ * @param targets per-thread target vertices
+ * @param weights per-thread edge weights
+ * @param counts per-thread number of edges read
+ * @param rows number of rows/vertices
+ * @param times time taken by each phase (updated, optional)
+ */
+template <bool WEIGHTED=false, int PARTITIONS=4, class IO, class IK, class IE, class IIO, class IIK, class IIE>
+inline void convertEdgelistToCsrListsOmpW(IO offsets, IK edgeKeys, IE edgeValues, IIO poffsets, IIK pedgeKeys, IIE pedgeValues, IIK degrees, IIK sources, IIK targets, IIE weights, const vector<size_t>& counts, size_t rows, CsrPhaseTimes *times=nullptr) {
+  auto fe = [&](auto fp) {
+    #pragma omp parallel
+    {
+      const int t = omp_get_thread_num();
+      const int p = t % PARTITIONS;
+      size_t I = counts[t];
+      for (size_t i=0; i<I; ++i) {
+        if constexpr (WEIGHTED) fp(p, sources[t][i], targets[t][i], weights[t][i]);
+        else fp(p, sources[t][i], targets[t][i], 0);
+      }
+    }
+  };
+  convertEdgelistToCsrDoOmpW<WEIGHTED, PARTITIONS>(offsets, edgeKeys, edgeValues, poffsets, pedgeKeys, pedgeValues, degrees, rows, fe, times);
+}
+
+
+/**
+ * Convert Edgelist format, recorded in a bounded scratch buffer, to CSR format.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param offsets CSR offsets (output)
+ * @param edgeKeys CSR edge keys (output)
+ * @param edgeValues CSR edge values (output)
+ * @param degrees per-partition vertex degrees (updated)
+ * @param buf scratch buffer with edges, chunks tagged by partition (updated)
+ * @param rows number of rows/vertices
+ * @param symmetric is graph symmetric (add reverse edges, which were counted but not stored)
+ * @param times time taken by each phase (updated, optional)
+ * @note Per-partition CSR is allocated in the scratch buffer, sized to the edges in each partition.
+ * @note If symmetric, edgeKeys and edgeValues must have room for twice the edges in the buffer (2*size), and degrees must include the reverse edges.
+ */
+template <bool WEIGHTED=false, int PARTITIONS=4, class IO, class IK, class IE, class IIK, class K, class E, class O>
+inline void convertEdgelistBufferToCsrOmpW(IO offsets, IK edgeKeys, IE edgeValues, IIK degrees, EdgelistBuffer<K, E, O>& buf, size_t rows, bool symmetric=false, CsrPhaseTimes *times=nullptr) {
+  const size_t CHUNK = buf.chunkSize;
+  // Allocate per-partition CSR.
+  vector<O*> poffsets(PARTITIONS);
+  vector<K*> pedgeKeys(PARTITIONS);
+  vector<E*> pedgeValues(PARTITIONS);
+  if (PARTITIONS>1) {
+    vector<size_t> sizes(PARTITIONS);
+    for (size_t c=0; c<buf.used; ++c)
+      sizes[buf.tags[c]] += (symmetric? 2 : 1) * buf.counts[c];
+    buf.poffsets.resize(PARTITIONS);
+    buf.pedgeKeys.resize(PARTITIONS);
+    buf.pedgeValues.resize(PARTITIONS);
+    for (int p=0; p<PARTITIONS; ++p) {
+      buf.poffsets[p]  = MappedPtr<O>((rows+1) * sizeof(O), buf.huge);
+      buf.pedgeKeys[p] = MappedPtr<K>(sizes[p] * sizeof(K), buf.huge);
+      if (WEIGHTED) buf.pedgeValues[p] = MappedPtr<E>(sizes[p] * sizeof(E), buf.huge);
+      poffsets[p]    = buf.poffsets[p];
+      pedgeKeys[p]   = buf.pedgeKeys[p];
+      pedgeValues[p] = buf.pedgeValues[p];
+    }
+  }
+  // Iterate over recorded chunks.
+  auto fe = [&](auto fp) {
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t c=0; c<buf.used; ++c) {
+      const int p = buf.tags[c];
+      const K *sources = buf.sources + c*CHUNK;
+      const K *targets = buf.targets + c*CHUNK;
+      const E *weights = WEIGHTED? buf.weights + c*CHUNK : nullptr;
+      size_t I = buf.counts[c];
+      for (size_t i=0; i<I; ++i) {
+        K u = sources[i], v = targets[i];
+        E w = WEIGHTED? weights[i] : E();
+        fp(p, u, v, w);
+        if (symmetric && u!=v) fp(p, v, u, w);
+      }
+    }
+  };
+  convertEdgelistToCsrDoOmpW<WEIGHTED, PARTITIONS>(offsets, edgeKeys, edgeValues, poffsets.data(), pedgeKeys.data(), pedgeValues.data(), degrees, rows, fe, times);
+}
+
+
+/**
+ * Convert Edgelist format, partitioned by source vertex range in a bounded scratch buffer, to CSR format.
+ * Each range is owned by one thread, which counts degrees, computes offsets, and scatters its edges without atomics.
+ * @tparam WEIGHTED is graph weighted?
+ * @param offsets CSR offsets (output)
+ * @param edgeKeys CSR edge keys (output)
+ * @param edgeValues CSR edge values (output)
+ * @param buf scratch buffer with edges, chunks tagged by range
+ * @param rows number of rows/vertices
+ * @param range number of vertices per range
+ * @param times time taken by each phase (updated, optional; degrees, offsets and scatter of a range are fused, and counted as scatter)
+ * @note Ranges are scheduled dynamically, so pages of offsets and edges are not placed near the thread that writes them.
+ */
+template <bool WEIGHTED=false, class IO, class IK, class IE, class K, class E, class O>
+inline void convertEdgelistRangesToCsrOmpW(IO offsets, IK edgeKeys, IE edgeValues, const EdgelistBuffer<K, E, O>& buf, size_t rows, size_t range, CsrPhaseTimes *times=nullptr) {
+  const size_t CHUNK = buf.chunkSize;
+  const size_t R     = max((rows + range-1) / range, size_t(1));
+  auto t0 = timeNow();
+  // Group chunks by range, and find the first edge of each range.
+  vector<size_t> cbegins(R+1), ebegins(R+1), chunks(buf.used);
+  for (size_t c=0; c<buf.used; ++c) {
+    ++cbegins[buf.tags[c]+1];
+    ebegins[buf.tags[c]+1] += buf.counts[c];
+  }
+  for (size_t r=0; r<R; ++r) {
+    cbegins[r+1] += cbegins[r];
+    ebegins[r+1] += ebegins[r];
+  }
+  vector<size_t> cnext(cbegins.begin(), cbegins.end()-1);
+  for (size_t c=0; c<buf.used; ++c)
+    chunks[cnext[buf.tags[c]]++] = c;
+  auto t1 = timeNow();
+  if (times) times->scan += duration(t0, t1);
+  // Build CSR of each range, using offsets[u+1] as degree, and then as insertion point of u.
+  offsets[0] = 0;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t r=0; r<R; ++r) {
+    const size_t a = r * range;
+    const size_t b = min(a + range, rows);
+    for (size_t u=a; u<b; ++u)
+      offsets[u+1] = 0;
+    // Count degrees.
+    for (size_t j=cbegins[r]; j<cbegins[r+1]; ++j) {
+      const size_t c = chunks[j];
+      const K *sources = buf.sources + c*CHUNK;
+      for (size_t i=0, I=buf.counts[c]; i<I; ++i)
+        ++offsets[sources[i]+1];
+    }
+    // Compute insertion points.
+    O s = O(ebegins[r]);
+    for (size_t u=a; u<b; ++u) {
+      O d = offsets[u+1];
+      offsets[u+1] = s;
+      s += d;
+    }
+    // Scatter edges, leaving offsets[u+1] at the end of u.
+    for (size_t j=cbegins[r]; j<cbegins[r+1]; ++j) {
+      const size_t c = chunks[j];
+      const K *sources = buf.sources + c*CHUNK;
+      const K *targets = buf.targets + c*CHUNK;
+      const E *weights = WEIGHTED? buf.weights + c*CHUNK : nullptr;
+      for (size_t i=0, I=buf.counts[c]; i<I; ++i) {
+        O k = offsets[sources[i]+1]++;
+        edgeKeys[k] = targets[i];
+        if constexpr (WEIGHTED) edgeValues[k] = weights[i];
+      }
+    }
+  }
+  if (times) times->scatter += duration(t1);
+}
+#pragma endregion
+
+
+
+
+#pragma region CANONICALIZE CSR
+/**
+ * Sort a range of elements in parallel, by sorting per-thread pieces and merging them pairwise [helper function].
+ * @param x elements (updated)
+ * @param N number of elements
+ * @param fl less-than comparator (a, b)
+ */
+template <class T, class FL>
+inline void sortRangeOmp(T *x, size_t N, FL fl) {
+  const size_t P = size_t(omp_get_max_threads());
+  const size_t S = (N + P-1) / P;
+  // Sort each piece.
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t p=0; p<P; ++p) {
+    size_t i = min(p*S, N), I = min(i+S, N);
+    sort(x+i, x+I, fl);
+  }
+  // Merge adjacent sorted pieces, doubling piece size each round.
+  for (size_t s=S; s<N; s*=2) {
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t i=0; i<N; i+=2*s) {
+      size_t m = min(i+s, N), I = min(i+2*s, N);
+      if (m<I) inplace_merge(x+i, x+m, x+I, fl);
+    }
+  }
+}
+
+
+/**
+ * Sort, and optionally remove duplicates and self-loops from, the outgoing edges of a vertex [helper function].
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam UNIQUE remove duplicate edges?
+ * @tparam LOOPS keep self-loops?
+ * @tparam HUB sort in parallel (for high-degree vertices)?
+ * @param edgeKeys CSR edge keys (updated)
+ * @param edgeValues CSR edge values (updated)
+ * @param u vertex id
+ * @param i offset of first edge of vertex
+ * @param I offset after last edge of vertex
+ * @param pairs scratch space for sorting weighted edges (updated)
+ * @param fc combine weights of duplicate edges (a, b)
+ * @returns number of edges left, packed from offset i
+ */
+template <bool WEIGHTED, bool UNIQUE, bool LOOPS, bool HUB, class IK, class IE, class K, class E, class FC>
+inline size_t canonicalizeCsrVertexW(IK edgeKeys, IE edgeValues, K u, size_t i, size_t I, vector<pair<K, E>>& pairs, FC fc) {
+  auto fl = [](const auto& a, const auto& b) { return a < b; };
+  // Sort edges by target, and then by weight (so that combining duplicates is deterministic).
+  if constexpr (WEIGHTED) {
+    pairs.resize(I-i);
+    for (size_t k=i; k<I; ++k)
+      pairs[k-i] = {edgeKeys[k], edgeValues[k]};
+    if constexpr (HUB) sortRangeOmp(pairs.data(), pairs.size(), fl);
+    else sort(pairs.begin(), pairs.end(), fl);
+  }
+  else {
+    if constexpr (HUB) sortRangeOmp(&edgeKeys[i], I-i, fl);
+    else sort(&edgeKeys[i], &edgeKeys[i] + (I-i), fl);
+  }
+  // Pack edges, skipping self-loops and combining duplicates.
+  size_t j = i;
+  for (size_t k=i; k<I; ++k) {
+    K v = WEIGHTED? pairs[k-i].first : edgeKeys[k];
+    if (!LOOPS && v==u) continue;
+    if (UNIQUE && j>i && edgeKeys[j-1]==v) {
+      if constexpr (WEIGHTED) edgeValues[j-1] = fc(edgeValues[j-1], pairs[k-i].second);
+      continue;
+    }
+    edgeKeys[j] = v;
+    if constexpr (WEIGHTED) edgeValues[j] = pairs[k-i].second;
+    ++j;
+  }
+  return j - i;
+}
+
+
+/**
+ * Canonicalize CSR in place: sort the outgoing edges of each vertex, and optionally remove duplicate edges and self-loops.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam UNIQUE remove duplicate edges?
+ * @tparam LOOPS keep self-loops?
+ * @param offsets CSR offsets (updated)
+ * @param edgeKeys CSR edge keys (updated)
+ * @param edgeValues CSR edge values (updated)
+ * @param degrees vertex degrees (output)
+ * @param rows number of rows/vertices
+ * @param fc combine weights of duplicate edges (a, b)
+ * @returns number of edges left
+ */
+template <bool WEIGHTED=false, bool UNIQUE=true, bool LOOPS=false, class IO, class IK, class IE, class ID, class FC>
+inline size_t canonicalizeCsrOmpW(IO offsets, IK edgeKeys, IE edgeValues, ID degrees, size_t rows, FC fc) {
+  using O = remove_reference_t<decltype(offsets[0])>;
+  using K = remove_reference_t<decltype(edgeKeys[0])>;
+  using E = remove_reference_t<decltype(edgeValues[0])>;
+  const size_t T = size_t(omp_get_max_threads());
+  const size_t M = offsets[rows];
+  const size_t HUB = max(M / (4*T), size_t(65536));  // Vertices with more edges are sorted in parallel
+  // Process low-degree vertices in parallel.
+  #pragma omp parallel
+  {
+    vector<pair<K, E>> pairs;
+    #pragma omp for schedule(dynamic, 2048)
+    for (size_t u=0; u<rows; ++u) {
+      size_t i = offsets[u], I = offsets[u+1];
+      if (I-i > HUB) continue;
+      degrees[u] = canonicalizeCsrVertexW<WEIGHTED, UNIQUE, LOOPS, false>(edgeKeys, edgeValues, K(u), i, I, pairs, fc);
+    }
+  }
+  // Process high-degree vertices, each in parallel.
+  vector<pair<K, E>> pairs;
+  for (size_t u=0; u<rows; ++u) {
+    size_t i = offsets[u], I = offsets[u+1];
+    if (I-i <= HUB) continue;
+    degrees[u] = canonicalizeCsrVertexW<WEIGHTED, UNIQUE, LOOPS, true>(edgeKeys, edgeValues, K(u), i, I, pairs, fc);
+  }
+  if (!UNIQUE && LOOPS) return M;
+  // Pack edges within each block of vertices (blocks have disjoint edges).
+  vector<size_t> begins(T+1), sizes(T);
+  for (size_t t=0; t<=T; ++t)
+    begins[t] = min(t * ((rows + T-1) / T), rows);
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t t=0; t<T; ++t) {
+    size_t j = offsets[begins[t]];
+    for (size_t u=begins[t]; u<begins[t+1]; ++u) {
+      size_t i = offsets[u], d = degrees[u];
+      if (i!=j) {
+        memmove(&edgeKeys[j], &edgeKeys[i], d * sizeof(K));
+        if constexpr (WEIGHTED) memmove(&edgeValues[j], &edgeValues[i], d * sizeof(E));
+      }
+      j += d;
+    }
+    sizes[t] = j - offsets[begins[t]];
+  }
+  vector<size_t> starts(T);
+  for (size_t t=0; t<T; ++t)
+    starts[t] = offsets[begins[t]];
+  // Compute new offsets.
+  vector<O> buf(T);
+  offsets[rows] = exclusiveScanOmpW(&offsets[0], buf.data(), &degrees[0], rows);
+  // Pack blocks in parallel. A block only moves left, so its source can be overwritten only by the
+  // destinations of later blocks, i.e. the part in [next block start, m); stage just that part first
+  // (bounded by the edges removed before the block).
+  const size_t m = offsets[rows];
+  vector<size_t> sheads(T), stails(T), soffsets(T+1);
+  for (size_t t=0; t<T; ++t) {
+    size_t i = starts[t], e = min(i + sizes[t], m);
+    size_t b = max(i, size_t(offsets[begins[t+1]]));
+    sheads[t] = b<e? b - i : sizes[t];
+    stails[t] = b<e? e - b : 0;
+    soffsets[t+1] = soffsets[t] + stails[t];
+  }
+  MappedPtr<K> skeys(soffsets[T] * sizeof(K));
+  MappedPtr<E> svalues(WEIGHTED? soffsets[T] * sizeof(E) : 0);
+  if (soffsets[T]>0 && (!skeys || (WEIGHTED && !svalues))) throw std::bad_alloc();
+  #pragma omp parallel
+  {
+    #pragma omp for schedule(dynamic, 1)
+    for (size_t t=0; t<T; ++t) {
+      if (stails[t]==0) continue;
+      size_t i = starts[t] + sheads[t], s = soffsets[t];
+      memcpy(&skeys[s], &edgeKeys[i], stails[t] * sizeof(K));
+      if constexpr (WEIGHTED) memcpy(&svalues[s], &edgeValues[i], stails[t] * sizeof(E));
+    }
+    #pragma omp for schedule(dynamic, 1)
+    for (size_t t=0; t<T; ++t) {
+      size_t i = starts[t], j = offsets[begins[t]];
+      if (i==j || sizes[t]==0) continue;
+      // Head from the source, staged part, then the rest (which lies past m, and is never overwritten).
+      size_t h = sheads[t], g = stails[t], r = sizes[t] - h - g, s = soffsets[t];
+      memmove(&edgeKeys[j], &edgeKeys[i], h * sizeof(K));
+      if (g>0) memcpy(&edgeKeys[j+h], &skeys[s], g * sizeof(K));
+      memmove(&edgeKeys[j+h+g], &edgeKeys[i+h+g], r * sizeof(K));
+      if constexpr (WEIGHTED) {
+        memmove(&edgeValues[j], &edgeValues[i], h * sizeof(E));
+        if (g>0) memcpy(&edgeValues[j+h], &svalues[s], g * sizeof(E));
+        memmove(&edgeValues[j+h+g], &edgeValues[i+h+g], r * sizeof(E));
+      }
+    }
+  }
+  return m;
+}
+
+
+/**
+ * Canonicalize CSR in place: sort the outgoing edges of each vertex, and optionally remove duplicate edges (summing weights) and self-loops.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam UNIQUE remove duplicate edges?
+ * @tparam LOOPS keep self-loops?
+ * @param offsets CSR offsets (updated)
+ * @param edgeKeys CSR edge keys (updated)
+ * @param edgeValues CSR edge values (updated)
+ * @param degrees vertex degrees (output)
+ * @param rows number of rows/vertices
+ * @returns number of edges left
+ */
+template <bool WEIGHTED=false, bool UNIQUE=true, bool LOOPS=false, class IO, class IK, class IE, class ID>
+inline size_t canonicalizeCsrOmpW(IO offsets, IK edgeKeys, IE edgeValues, ID degrees, size_t rows) {
+  auto fc = [](auto a, auto b) { return a + b; };
+  return canonicalizeCsrOmpW<WEIGHTED, UNIQUE, LOOPS>(offsets, edgeKeys, edgeValues, degrees, rows, fc);
+}
+#pragma endregion
+
+
+
+
+#pragma region READ SPARSE EDGELIST FORMAT
+/**
+ * Get the size of the leading comment lines of a headerless Edgelist (starting with '#' or '%') [helper function].
+ * @param data input file data
+ * @returns number of characters to skip
+ */
+inline size_t edgelistCommentsSize(string_view data) {
+  auto ib = data.begin(), ie = data.end(), it = ib;
+  while (it!=ie && (*it=='#' || *it=='%'))
+    it = findNextLine(it, ie);
+  return it - ib;
+}
+
+
+#ifdef OPENMP
+/**
+ * Count the number of lines in Edgelist data, in parallel (an upper bound on the number of edges).
+ * @param data input file data
+ * @returns number of lines
+ */
+inline size_t countEdgelistLinesOmp(string_view data) {
+  const size_t DATA  = data.size();
+  const size_t BLOCK = 1024 * 1024;  // Characters per block (1MB)
+  const char  *x = data.data();
+  size_t a = 1;
+  #pragma omp parallel for schedule(dynamic) reduction(+:a)
+  for (size_t b=0; b<DATA; b+=BLOCK)
+    a += count(x+b, x+min(b+BLOCK, DATA), '\n');
+  return a;
+}
+
+
+/**
+ * Read an EdgeList format file, and record the edges into a bounded scratch buffer (without vertex degrees).
+ * Used for sparse vertex ids, which are relabeled afterwards.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam CHECK check for error?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param buf scratch buffer for edges with original vertex ids, chunks tagged by partition (updated)
+ * @param data input file data
+ */
+template <bool WEIGHTED=false, bool CHECK=false, int PARTITIONS=4, class E, class O>
+inline void readSparseEdgelistFormatToBufferOmpU(EdgelistBuffer<uint64_t, E, O>& buf, string_view data) {
+  const size_t DATA  = data.size();
+  const size_t BLOCK = 256 * 1024;  // Characters per block (256KB)
+  FormatError err;    // Common error
+  bool full = false;  // Scratch buffer exhausted?
+  // Process a grid in parallel with dynamic scheduling.
+  #pragma omp parallel shared(err, full)
+  {
+    const int t = omp_get_thread_num();
+    EdgelistBufferWriter<uint64_t, E, O> wr(buf, t % PARTITIONS);
+    #pragma omp for schedule(dynamic) nowait
+    for (size_t b=0; b<DATA; b+=BLOCK) {
+      bool stop = false;
+      #pragma omp atomic read
+      stop = full;
+      if (stop || (CHECK && !err.empty())) continue;
+      // Read a block of data, and process it.
+      string_view bdata = readEdgelistFormatBlock(data, b, BLOCK);
+      auto fb = [&](auto u, auto v, auto w) {
+        if (!wr.template push<WEIGHTED>(uint64_t(u), uint64_t(v), E(w))) {
+          #pragma omp atomic write
+          full = true;
+        }
+      };
+      if constexpr (CHECK) {
+        try { readEdgelistFormatDo<WEIGHTED, 0, true>(bdata, false, fb); }
+        catch (const FormatError& e) {
+          #pragma omp critical
+          if (err.empty()) err = e;
+        }
+      }
+      else readEdgelistFormatDo<WEIGHTED, 0>(bdata, false, fb);
+    }
+    // Update size of last chunk.
+    wr.flush();
+  }
+  buf.used = min(buf.used, buf.chunks);
+  // Throw error if any.
+  if (CHECK && !err.empty()) throw err;
+  if (full) throw FormatError("Edgelist exceeds scratch buffer capacity");
+}
+
+
+/**
+ * Insert the vertex ids of recorded edges into a concurrent hash table, growing it as needed.
+ * Chunks are processed in rounds, each inserting at most a quarter of the slots, and the
+ * table is grown between rounds once it is half full; so it never fills up.
+ * @param map hash table of vertex ids (updated)
+ * @param buf scratch buffer with edges, with original vertex ids
+ * @returns number of distinct vertex ids
+ */
+template <class K, class E, class O>
+inline size_t insertEdgelistBufferIdsOmp(ConcurrentHashTable<K>& map, const EdgelistBuffer<uint64_t, E, O>& buf) {
+  const size_t C = buf.chunkSize;
+  size_t n = 0;
+  for (size_t c=0; c<buf.used;) {
+    size_t R = max(map.capacity / (8*C), size_t(1));
+    size_t D = min(c+R, buf.used);
+    size_t a = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:a)
+    for (size_t d=c; d<D; ++d) {
+      const uint64_t *sources = buf.sources + d*C;
+      const uint64_t *targets = buf.targets + d*C;
+      for (size_t i=0, I=buf.counts[d]; i<I; ++i) {
+        a += map.insert(sources[i]);
+        a += map.insert(targets[i]);
+      }
+    }
+    n += a; c = D;
+    if (n > map.capacity/2) map.rehashOmp(2 * map.capacity);
+  }
+  return n;
+}
+
+
+/**
+ * Sort 64-bit keys with a parallel, stable LSD radix sort (8 bits per pass) [helper function].
+ * Passes where all keys have the same digit are skipped.
+ * @param a keys (updated)
+ * @param b scratch space for keys (at least N)
+ * @param N number of keys
+ */
+inline void radixSortKeysOmpW(uint64_t *a, uint64_t *b, size_t N) {
+  const size_t T = omp_get_max_threads();
+  const size_t B = (N + T-1) / T;
+  uint64_t *x = a;
+  vector<size_t> counts(T * 256);
+  for (int s=0; s<64; s+=8) {
+    // Count keys with each digit, in each block.
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t t=0; t<T; ++t) {
+      size_t *c = &counts[t*256];
+      fill(c, c+256, size_t());
+      for (size_t i=min(t*B, N), I=min(i+B, N); i<I; ++i)
+        ++c[(a[i] >> s) & 255];
+    }
+    // Find where each block writes its keys with each digit (digit-major order).
+    size_t o = 0; bool same = false;
+    for (size_t d=0; d<256; ++d) {
+      size_t o0 = o;
+      for (size_t t=0; t<T; ++t) {
+        size_t c = counts[t*256+d];
+        counts[t*256+d] = o; o += c;
+      }
+      same = same || o-o0==N;
+    }
+    if (same) continue;
+    // Scatter keys, in order within each block.
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t t=0; t<T; ++t) {
+      size_t *c = &counts[t*256];
+      for (size_t i=min(t*B, N), I=min(i+B, N); i<I; ++i)
+        b[c[(a[i] >> s) & 255]++] = a[i];
+    }
+    swap(a, b);
+  }
+  // Move keys back, if they ended in the scratch space.
+  if (a!=x) {
+    #pragma omp parallel for schedule(static, 4096)
+    for (size_t i=0; i<N; ++i)
+      x[i] = a[i];
+  }
+}
+
+
+/**
+ * Assign dense ids to the keys of a hash table, in ascending order of keys.
+ * The mapping is deterministic, and preserves the relative order of the original ids.
+ * @param ids original id of each dense id (output)
+ * @param map hash table of vertex ids (values updated)
+ * @param n number of keys in hash table (must fit in K)
+ */
+template <class K>
+inline void denseIdsOmpW(uint64_t *ids, ConcurrentHashTable<K>& map, size_t n) {
+  const size_t S = map.capacity;
+  const size_t T = omp_get_max_threads();
+  const size_t B = (S + T-1) / T;
+  vector<size_t> counts(T+1);
+  // Gather keys, in slot order, with each thread counting and then writing its block.
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t t=0; t<T; ++t) {
+    size_t a = 0; uint64_t k = 0;
+    for (size_t i=min(t*B, S), I=min(i+B, S); i<I; ++i)
+      a += map.keyAt(k, i);
+    counts[t+1] = a;
+  }
+  for (size_t t=0; t<T; ++t)
+    counts[t+1] += counts[t];
+  #pragma omp parallel for schedule(static, 1)
+  for (size_t t=0; t<T; ++t) {
+    size_t j = counts[t]; uint64_t k = 0;
+    for (size_t i=min(t*B, S), I=min(i+B, S); i<I; ++i)
+      if (map.keyAt(k, i)) ids[j++] = k;
+  }
+  if (map.largest) ids[n-1] = uint64_t(-1);
+  // Sort keys, and assign dense ids.
+  MappedPtr<uint64_t> buf(n * sizeof(uint64_t));
+  if (n>0 && !buf) throw std::bad_alloc();
+  radixSortKeysOmpW(ids, buf.data(), n);
+  #pragma omp parallel for schedule(static, 4096)
+  for (size_t i=0; i<n; ++i)
+    map.values[map.find(ids[i])] = K(i);
+}
+
+
+/**
+ * Relabel recorded edges from original to dense vertex ids, and count vertex degrees.
+ * @tparam WEIGHTED is graph weighted?
+ * @param degrees per-partition vertex degrees (updated)
+ * @param a scratch buffer for edges with dense vertex ids, with the same chunks as x (output)
+ * @param x scratch buffer with edges, with original vertex ids, chunks tagged by partition
+ * @param map hash table from original to dense vertex ids
+ * @param symmetric is graph symmetric (reverse edges are counted, but not stored)
+ */
+template <bool WEIGHTED=false, class IIK, class K, class E, class O>
+inline void relabelEdgelistBufferOmpU(IIK degrees, EdgelistBuffer<K, E, O>& a, const EdgelistBuffer<uint64_t, E, O>& x, const ConcurrentHashTable<K>& map, bool symmetric) {
+  const size_t C = x.chunkSize;
+  a.used = x.used;
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c=0; c<x.used; ++c) {
+    const int p = x.tags[c];
+    const size_t I = x.counts[c];
+    const uint64_t *xsources = x.sources + c*C;
+    const uint64_t *xtargets = x.targets + c*C;
+    K *asources = a.sources + c*C;
+    K *atargets = a.targets + c*C;
+    for (size_t i=0; i<I; ++i) {
+      K u = map.get(xsources[i]);
+      K v = map.get(xtargets[i]);
+      asources[i] = u;
+      atargets[i] = v;
+      #pragma omp atomic
+      ++degrees[p][u];
+      if (symmetric && u!=v) {
+        #pragma omp atomic
+        ++degrees[p][v];
+      }
+    }
+    if constexpr (WEIGHTED) memcpy(a.weights + c*C, x.weights + c*C, I * sizeof(E));
+    a.counts[c] = I;
+    a.tags[c]   = p;
+  }
+}
+
+
+/**
+ * Read a file in Edgelist format with sparse (64-bit) vertex ids, and convert it to CSR with dense vertex ids.
+ * The file may have an MTX header, or none (with optional leading comments, as in SNAP).
+ * Edges are parsed into a scratch buffer with original ids, the ids are collected in a concurrent hash
+ * table, and dense ids are assigned in ascending order of original ids; then the edges are relabeled.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam CHECK check for error?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param a output CSR, with dense vertex ids (updated)
+ * @param data input file data
+ * @param times time taken by each phase (updated, optional)
+ * @returns original id of each vertex (inverse mapping)
+ */
+template <bool WEIGHTED=false, bool CHECK=false, int PARTITIONS=4, class K, class V, class E, class O, tclass1 S>
+inline S<uint64_t> readSparseEdgelistFormatOmpW(DiGraphCsr<K, V, E, O, S>& a, string_view data, CsrPhaseTimes *times=nullptr) {
+  const int T = omp_get_max_threads();
+  auto fm = [&](float CsrPhaseTimes::*m, auto t0) { if (times) times->*m += duration(t0); };
+  // Skip header (if any), and bound the number of edges.
+  auto t0 = timeNow();
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+  if (data.substr(0, 14)=="%%MatrixMarket") data = data.substr(readMtxFormatHeaderW(symmetric, rows, cols, size, data));
+  else { data = data.substr(edgelistCommentsSize(data)); size = countEdgelistLinesOmp(data); }
+  // Read edges with original ids.
+  EdgelistBuffer<uint64_t, E, O> x(size, WEIGHTED, T);
+  readSparseEdgelistFormatToBufferOmpU<WEIGHTED, CHECK, PARTITIONS>(x, data);
+  fm(&CsrPhaseTimes::parse, t0);
+  // Map original ids to dense ids.
+  auto t1 = timeNow();
+  size_t H = 1;  // Initial slots, enough for 2 chunks per thread per round (or for all ids)
+  while (H < min(size_t(16) * T * x.chunkSize, 8 * x.size())) H *= 2;
+  ConcurrentHashTable<K> map(max(H, size_t(1) << 16));
+  size_t N = insertEdgelistBufferIdsOmp(map, x);
+  if (N > size_t(numeric_limits<K>::max())) throw FormatError("Edgelist has more distinct vertex-ids than the key type can hold");
+  S<uint64_t> ids;
+  ids.resize(N);
+  denseIdsOmpW(ids.data(), map, N);
+  // Relabel edges, and count degrees.
+  vector<S<K>> degrees(PARTITIONS);
+  vector<K*>   pdegrees(PARTITIONS);
+  for (int p=0; p<PARTITIONS; ++p) {
+    degrees[p].resize(N+1);
+    pdegrees[p] = degrees[p].data();
+  }
+  EdgelistBuffer<K, E, O> y(x.capacity(), WEIGHTED, 0, x.chunkSize);
+  relabelEdgelistBufferOmpU<WEIGHTED>(pdegrees.data(), y, x, map, symmetric);
+  x = EdgelistBuffer<uint64_t, E, O>(0, false, 0);
+  fm(&CsrPhaseTimes::relabel, t1);
+  // Convert to CSR.
+  const size_t M = y.size();
+  a.resize(N, symmetric? 2*M : M);
+  convertEdgelistBufferToCsrOmpW<WEIGHTED, PARTITIONS>(a.offsets.data(), a.edgeKeys.data(), a.edgeValues.data(), pdegrees.data(), y, N, symmetric, times);
+  a.edgeKeys.resize(a.offsets[N]);
+  a.edgeValues.resize(a.offsets[N]);
+  return ids;
+}
+#endif
+#pragma endregion
+
+
+
+
+#pragma region CSR SNAPSHOT FORMAT
+/**
+ * Mix the bits of a 64-bit word (splitmix64 finalizer) [helper function].
+ * @param x input word
+ * @returns mixed word
+ */
+inline uint64_t csrSnapshotMix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+
+/**
+ * Compute the checksum of a section of a CSR snapshot [helper function].
+ * @param data section data
+ * @param bytes section size in bytes
+ * @returns checksum of the section
+ */
+inline uint64_t csrSnapshotChecksum(const void *data, size_t bytes) {
+  const char *x = (const char*) data;
+  const size_t W = bytes / 8;
+  uint64_t a = 0;
+  for (size_t i=0; i<W; ++i) {
+    uint64_t w; memcpy(&w, x + 8*i, 8);
+    a += csrSnapshotMix(w + i);
+  }
+  if (bytes % 8) {
+    uint64_t w = 0; memcpy(&w, x + 8*W, bytes % 8);
+    a += csrSnapshotMix(w + W);
+  }
+  return a;
+}
+
+
+#ifdef OPENMP
+/**
+ * Compute the checksum of a section of a CSR snapshot in parallel [helper function].
+ * @param data section data
+ * @param bytes section size in bytes
+ * @returns checksum of the section
+ */
+inline uint64_t csrSnapshotChecksumOmp(const void *data, size_t bytes) {
+  const char *x = (const char*) data;
+  const size_t W = bytes / 8;
+  uint64_t a = 0;
+  #pragma omp parallel for schedule(static, 65536) reduction(+:a)
+  for (size_t i=0; i<W; ++i) {
+    uint64_t w; memcpy(&w, x + 8*i, 8);
+    a += csrSnapshotMix(w + i);
+  }
+  if (bytes % 8) {
+    uint64_t w = 0; memcpy(&w, x + 8*W, bytes % 8);
+    a += csrSnapshotMix(w + W);
+  }
+  return a;
+}
+#endif
+
+
+/**
+ * Combine the checksums of the header and the sections of a CSR snapshot [helper function].
+ * @param h snapshot header (its checksum field is ignored)
+ * @param co checksum of offsets section
+ * @param ck checksum of edge keys section
+ * @param cv checksum of edge values section
+ * @returns combined checksum
+ */
+inline uint64_t csrSnapshotCombine(const CsrSnapshotHeader& h, uint64_t co, uint64_t ck, uint64_t cv) {
+  CsrSnapshotHeader g = h;
+  g.checksum = 0;
+  uint64_t ch = csrSnapshotChecksum(&g, sizeof(g));
+  return csrSnapshotMix(co) ^ csrSnapshotMix(ck + 1) ^ csrSnapshotMix(cv + 2) ^ csrSnapshotMix(ch + 3);
+}
+
+
+/**
+ * Generate the header of a CSR snapshot, without checksum.
+ * @tparam K key type (vertex id)
+ * @tparam E edge value type (edge weight)
+ * @tparam O offset type
+ * @param rows number of rows/vertices
+ * @param size number of edges
+ * @param weighted store edge values?
+ * @param sorted are the outgoing edges of each vertex sorted?
+ * @returns snapshot header
+ */
+template <class K, class E, class O>
+inline CsrSnapshotHeader csrSnapshotHeader(size_t rows, size_t size, bool weighted, bool sorted=false) {
+  using H = CsrSnapshotHeader;
+  H h;
+  memset(&h, 0, sizeof(H));
+  memcpy(h.magic, H::MAGIC, sizeof(H::MAGIC));
+  h.version         = H::VERSION;
+  h.flags           = (weighted? H::WEIGHTED : 0) | (sorted? H::SORTED : 0);
+  h.order           = rows;
+  h.size            = size;
+  h.keyBytes        = sizeof(K);
+  h.edgeValueBytes  = sizeof(E);
+  h.offsetBytes     = sizeof(O);
+  h.alignment       = H::ALIGNMENT;
+  h.offsetsStart    = bytesof<H, H::ALIGNMENT>(1);
+  h.edgeKeysStart   = h.offsetsStart  + bytesof<O, H::ALIGNMENT>(rows+1);
+  h.edgeValuesStart = h.edgeKeysStart + bytesof<K, H::ALIGNMENT>(size);
+  h.fileSize        = h.edgeValuesStart + (weighted? bytesof<E, H::ALIGNMENT>(size) : 0);
+  return h;
+}
+
+
+/**
+ * Write a section of a CSR snapshot at a given file offset [helper function].
+ * @param fd file descriptor
+ * @param data section data
+ * @param bytes section size in bytes
+ * @param start file offset of the section
+ * @returns success?
+ */
+inline bool writeCsrSnapshotSection(int fd, const void *data, size_t bytes, size_t start) {
+  const char *x = (const char*) data;
+  while (bytes>0) {
+    ssize_t n = pwrite(fd, x, bytes, start);
+    if (n<=0) return false;
+    x += n; bytes -= n; start += n;
+  }
+  return true;
+}
+
+
+/**
+ * Write a CSR snapshot file.
+ * @tparam WEIGHTED is graph weighted?
+ * @param pth file path
+ * @param offsets CSR offsets [rows+1]
+ * @param edgeKeys CSR edge keys [size]
+ * @param edgeValues CSR edge values [size]
+ * @param rows number of rows/vertices
+ * @param size number of edges
+ * @param sorted are the outgoing edges of each vertex sorted?
+ * @returns success?
+ */
+template <bool WEIGHTED=false, class K, class E, class O>
+inline bool writeCsrSnapshot(const char *pth, const O *offsets, const K *edgeKeys, const E *edgeValues, size_t rows, size_t size, bool sorted=false) {
+  auto h  = csrSnapshotHeader<K, E, O>(rows, size, WEIGHTED, sorted);
+  auto co = csrSnapshotChecksum(offsets,  (rows+1) * sizeof(O));
+  auto ck = csrSnapshotChecksum(edgeKeys, size * sizeof(K));
+  auto cv = WEIGHTED? csrSnapshotChecksum(edgeValues, size * sizeof(E)) : 0;
+  h.checksum = csrSnapshotCombine(h, co, ck, cv);
+  int fd = open(pth, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd==-1) return false;
+  bool ok = ftruncate(fd, h.fileSize)==0;
+  ok = ok && writeCsrSnapshotSection(fd, &h, sizeof(h), 0);
+  ok = ok && writeCsrSnapshotSection(fd, offsets,  (rows+1) * sizeof(O), h.offsetsStart);
+  ok = ok && writeCsrSnapshotSection(fd, edgeKeys, size * sizeof(K), h.edgeKeysStart);
+  if (WEIGHTED) ok = ok && writeCsrSnapshotSection(fd, edgeValues, size * sizeof(E), h.edgeValuesStart);
+  close(fd);
+  return ok;
+}
+
+
+#ifdef OPENMP
+/**
+ * Write a section of a CSR snapshot at a given file offset, in parallel [helper function].
+ * @param fd file descriptor
+ * @param data section data
+ * @param bytes section size in bytes
+ * @param start file offset of the section
+ * @returns success?
+ */
+inline bool writeCsrSnapshotSectionOmp(int fd, const void *data, size_t bytes, size_t start) {
+  const char  *x = (const char*) data;
+  const size_t BLOCK = 4 * 1024 * 1024;  // Bytes per block (4MB)
+  bool ok = true;
+  #pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+  for (size_t b=0; b<bytes; b+=BLOCK)
+    ok = writeCsrSnapshotSection(fd, x+b, min(BLOCK, bytes-b), start+b) && ok;
+  return ok;
+}
+
+
+/**
+ * Write a CSR snapshot file in parallel.
+ * @tparam WEIGHTED is graph weighted?
+ * @param pth file path
+ * @param offsets CSR offsets [rows+1]
+ * @param edgeKeys CSR edge keys [size]
+ * @param edgeValues CSR edge values [size]
+ * @param rows number of rows/vertices
+ * @param size number of edges
+ * @param sorted are the outgoing edges of each vertex sorted?
+ * @returns success?
+ */
+template <bool WEIGHTED=false, class K, class E, class O>
+inline bool writeCsrSnapshotOmp(const char *pth, const O *offsets, const K *edgeKeys, const E *edgeValues, size_t rows, size_t size, bool sorted=false) {
+  auto h  = csrSnapshotHeader<K, E, O>(rows, size, WEIGHTED, sorted);
+  auto co = csrSnapshotChecksumOmp(offsets,  (rows+1) * sizeof(O));
+  auto ck = csrSnapshotChecksumOmp(edgeKeys, size * sizeof(K));
+  auto cv = WEIGHTED? csrSnapshotChecksumOmp(edgeValues, size * sizeof(E)) : 0;
+  h.checksum = csrSnapshotCombine(h, co, ck, cv);
+  int fd = open(pth, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd==-1) return false;
+  bool ok = ftruncate(fd, h.fileSize)==0;
+  ok = ok && writeCsrSnapshotSection(fd, &h, sizeof(h), 0);
+  ok = ok && writeCsrSnapshotSectionOmp(fd, offsets,  (rows+1) * sizeof(O), h.offsetsStart);
+  ok = ok && writeCsrSnapshotSectionOmp(fd, edgeKeys, size * sizeof(K), h.edgeKeysStart);
+  if (WEIGHTED) ok = ok && writeCsrSnapshotSectionOmp(fd, edgeValues, size * sizeof(E), h.edgeValuesStart);
+  close(fd);
+  return ok;
+}
+#endif
+
+
+/**
+ * Read a CSR snapshot from memory mapped data, without copying it.
+ * The first and last offsets are always checked; all offsets and edge keys only if CHECK.
+ * @tparam CHECK verify checksum, offsets, and edge keys?
+ * @param a CSR graph view (output)
+ * @param data snapshot file data (must outlive the view)
+ * @returns snapshot header
+ */
+template <bool CHECK=false, class K, class V, class E, class O>
+inline CsrSnapshotHeader readCsrSnapshotW(DiGraphCsrView<K, V, E, O>& a, string_view data) {
+  using H = CsrSnapshotHeader;
+  auto ib = data.begin();
+  if (data.size() < sizeof(H)) throw FormatError("Invalid CSR snapshot (truncated header)", ib);
+  H h; memcpy(&h, data.data(), sizeof(H));
+  // Check the layout.
+  if (memcmp(h.magic, H::MAGIC, sizeof(H::MAGIC))!=0) throw FormatError("Invalid CSR snapshot (bad magic)", ib);
+  if (h.version!=H::VERSION) throw FormatError("Invalid CSR snapshot (unknown version)", ib);
+  if (h.keyBytes!=sizeof(K) || h.offsetBytes!=sizeof(O)) throw FormatError("Invalid CSR snapshot (type width mismatch)", ib);
+  bool weighted = h.flags & H::WEIGHTED;
+  if (weighted && h.edgeValueBytes!=sizeof(E)) throw FormatError("Invalid CSR snapshot (type width mismatch)", ib);
+  // Check that the sections fit in the data, before computing the layout (which could overflow).
+  const size_t D  = data.size();
+  const size_t EB = sizeof(K) + (weighted? sizeof(E) : 0);
+  if (h.order >= D / sizeof(O) || h.size > D / EB) throw FormatError("Invalid CSR snapshot (sections exceed file size)", ib);
+  if ((h.order+1) * sizeof(O) + h.size * EB > D)   throw FormatError("Invalid CSR snapshot (sections exceed file size)", ib);
+  H g = csrSnapshotHeader<K, E, O>(h.order, h.size, weighted);
+  if (h.offsetsStart!=g.offsetsStart || h.edgeKeysStart!=g.edgeKeysStart || h.edgeValuesStart!=g.edgeValuesStart || h.fileSize!=g.fileSize) throw FormatError("Invalid CSR snapshot (bad section layout)", ib);
+  if (data.size() < h.fileSize) throw FormatError("Invalid CSR snapshot (truncated body)", ib);
+  // Expose the sections.
+  auto *x = data.data();
+  a.N = h.order;
+  a.M = h.size;
+  a.offsets    = (const O*) (x + h.offsetsStart);
+  a.edgeKeys   = (const K*) (x + h.edgeKeysStart);
+  a.edgeValues = weighted? (const E*) (x + h.edgeValuesStart) : nullptr;
+  a.values     = nullptr;
+  a.sorted     = h.flags & H::SORTED;
+  if (a.offsets[0]!=0 || a.offsets[a.N]!=a.M) throw FormatError("Invalid CSR snapshot (bad offsets)", ib);
+  // Verify the checksum, offsets, and edge keys, if requested.
+  if constexpr (CHECK) {
+    #ifdef OPENMP
+    auto co = csrSnapshotChecksumOmp(a.offsets,  (a.N+1) * sizeof(O));
+    auto ck = csrSnapshotChecksumOmp(a.edgeKeys, a.M * sizeof(K));
+    auto cv = weighted? csrSnapshotChecksumOmp(a.edgeValues, a.M * sizeof(E)) : 0;
+    #else
+    auto co = csrSnapshotChecksum(a.offsets,  (a.N+1) * sizeof(O));
+    auto ck = csrSnapshotChecksum(a.edgeKeys, a.M * sizeof(K));
+    auto cv = weighted? csrSnapshotChecksum(a.edgeValues, a.M * sizeof(E)) : 0;
+    #endif
+    if (csrSnapshotCombine(h, co, ck, cv)!=h.checksum) throw FormatError("Invalid CSR snapshot (checksum mismatch)", ib);
+    bool okOffsets = true, okKeys = true;
+    #pragma omp parallel for schedule(static, 4096) reduction(&&:okOffsets)
+    for (size_t u=0; u<a.N; ++u)
+      okOffsets = okOffsets && a.offsets[u] <= a.offsets[u+1];
+    if (!okOffsets) throw FormatError("Invalid CSR snapshot (bad offsets)", ib);
+    #pragma omp parallel for schedule(static, 4096) reduction(&&:okKeys)
+    for (size_t i=0; i<a.M; ++i)
+      okKeys = okKeys && size_t(a.edgeKeys[i]) < a.N;
+    if (!okKeys) throw FormatError("Invalid CSR snapshot (edge key exceeds order)", ib);
+  }
+  return h;
 }
 #pragma endregion
 #pragma endregion
@@ -2,5 +2,6 @@
 #define BUILD  0  // 5 == BUILD_TRACE
 #define OPENMP 1
 #include "_main.hxx"
-#include "io.hxx"
 #include "Graph.hxx"
+#include "io.hxx"
+#include "generate.hxx"
@@ -1,10 +1,15 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <memory>
 #include <string_view>
+#include <string>
 #include <vector>
 #include <fstream>
+#include <algorithm>
 #include "inc/main.hxx"
 
 using namespace std;
@@ -35,6 +40,735 @@ using namespace std;
 
 
 #pragma region METHODS
+/**
+ * Measure single-core Edgelist parsing throughput at each supported SIMD level.
+ * @tparam WEIGHTED is graph weighted?
+ * @param data input file data (body)
+ * @param rows number of rows/vertices
+ * @param size number of lines/edges
+ */
+template <bool WEIGHTED>
+inline void runParseEdgelist(string_view data, size_t rows, size_t size) {
+  uint64_t h0 = 0;
+  for (int l=SIMD_SCALAR; l<=SIMD_AVX512; ++l) {
+    if (!simdSupported(l)) continue;
+    uint64_t h = 0;
+    auto fb = [&](auto u, auto v, auto w) {
+      uint64_t wb = 0; double wd = w;
+      memcpy(&wb, &wd, sizeof(double));
+      h = (h*31 + u)*31 + v;
+      h = h*31 + wb;
+    };
+    float t = measureDuration([&]() {
+      h = 0;
+      readEdgelistFormatDoLevel<WEIGHTED, 1>(l, data, false, fb);
+    });
+    if (l==SIMD_SCALAR) h0 = h;
+    double rate = data.size() / (t * 1e6);
+    printf("{%09.1fms, order=%zu, size=%zu, rate=%.3fGB/s, same=%d} parseEdgelist%s\n", t, rows, size, rate, h==h0, simdName(l));
+  }
+}
+
+
+/**
+ * Check if two CSRs have the same edges, ignoring the order of edges of each vertex.
+ * @param x first CSR
+ * @param y second CSR
+ * @param weighted compare edge weights?
+ * @returns same edges?
+ */
+template <class G, class H>
+inline bool equalCsrUnordered(const G& x, const H& y, bool weighted) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  const size_t N = x.order();
+  if (N!=y.order()) return false;
+  if (!equal(x.offsets.begin(), x.offsets.begin()+N+1, y.offsets.begin())) return false;
+  bool a = true;
+  #pragma omp parallel for schedule(dynamic, 2048) reduction(&&:a)
+  for (size_t u=0; u<N; ++u) {
+    vector<pair<K, E>> ex, ey;
+    for (size_t i=x.offsets[u]; i<x.offsets[u+1]; ++i)
+      ex.push_back({x.edgeKeys[i], weighted? x.edgeValues[i] : E()});
+    for (size_t i=y.offsets[u]; i<y.offsets[u+1]; ++i)
+      ey.push_back({y.edgeKeys[i], weighted? y.edgeValues[i] : E()});
+    sort(ex.begin(), ex.end());
+    sort(ey.begin(), ey.end());
+    a = a && ex==ey;
+  }
+  return a;
+}
+
+
+/** Storage of CSR and loader scratch space: std::vector (value-initialized serially). */
+#define STORAGE_VECTOR   0
+/** Storage of CSR and loader scratch space: MappedVector with regular pages. */
+#define STORAGE_MAPPED   1
+/** Storage of CSR and loader scratch space: MappedVector with transparent huge pages. */
+#define STORAGE_THP      2
+/** Storage of CSR and loader scratch space: MappedVector with explicit huge pages. */
+#define STORAGE_HUGETLB  3
+
+/** MappedVector with regular pages. */
+template <class T>
+using MappedVectorNone = MappedVector<T, HUGE_PAGES_NONE>;
+/** MappedVector with transparent huge pages. */
+template <class T>
+using MappedVectorTransparent = MappedVector<T, HUGE_PAGES_TRANSPARENT>;
+/** MappedVector with explicit huge pages. */
+template <class T>
+using MappedVectorExplicit = MappedVector<T, HUGE_PAGES_EXPLICIT>;
+
+
+/**
+ * Benchmark options, from the command line.
+ */
+struct Options {
+  /** Input graph file (also output, if generating). */
+  const char *file = nullptr;
+  /** Is the graph weighted? */
+  bool weighted = false;
+  /** CSR snapshot file to write and read (optional). */
+  const char *snapshot = nullptr;
+  /** Thread counts to sweep. */
+  vector<int> threads;
+  /** Partition counts to sweep (0 for vertex ranges). */
+  vector<int> partitions;
+  /** Storage kinds to sweep (STORAGE_*). */
+  vector<int> storages;
+  /** Number of measured runs per configuration. */
+  int repeat = 5;
+  /** Number of unmeasured (warmup) runs per configuration. */
+  int warmup = 1;
+  /** Output format (text, csv, or json). */
+  string format = "text";
+  /** Graph generator (rmat, or uniform), if any. */
+  string generate;
+  /** Number of vertices to generate. */
+  size_t vertices = 1 << 20;
+  /** Number of edges to generate. */
+  size_t edges = 1 << 24;
+  /** R-MAT quadrant probabilities (a, b, c). */
+  double skew[3] = {0.57, 0.19, 0.19};
+  /** Random seed for generation. */
+  uint64_t seed = 42;
+  /** Read graph with sparse (64-bit) vertex ids only, relabeling them to dense ids? */
+  bool sparse = false;
+};
+
+
+/**
+ * Result of reading a graph with a CSR construction engine.
+ */
+struct Result {
+  /** Time taken to read MTX header (ms). */
+  float header = 0;
+  /** Time taken to allocate CSR and scratch space (ms). */
+  float alloc  = 0;
+  /** Time taken to parse Edgelist (ms). */
+  float parse  = 0;
+  /** Time taken by each phase of CSR conversion (ms). */
+  CsrPhaseTimes convert;
+  /** Total time taken (ms). */
+  float total  = 0;
+  /** Number of edges read. */
+  size_t read  = 0;
+  /** Scratch space used (bytes). */
+  size_t scratch = 0;
+};
+
+
+/**
+ * Read a graph with per-partition atomic degree counting and scatter, and convert it to CSR.
+ * @tparam WEIGHTED is graph weighted?
+ * @tparam PARTITIONS number of partitions for vertex degrees
+ * @param xc output CSR (updated)
+ * @param file input file data (header and body)
+ * @param huge huge page mode of scratch space (HUGE_PAGES_*)
+ * @returns time taken by each phase
+ */
+template <bool WEIGHTED, int PARTITIONS, class G>
+inline Result runReadGraph(G& xc, string_view file, int huge) {
+  using O = size_t;
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  const int T = omp_get_max_threads();
+  Result a;
+  // Read MTX header.
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+  auto t0 = timeNow();
+  size_t head = readMtxFormatHeaderW(symmetric, rows, cols, size, file);
+  string_view data = file.substr(head);
+  a.header = duration(t0);
+  // Allocate space for CSR, per-partition degrees (with the storage of CSR), and bounded scratch space for edges.
+  xc = G();
+  auto t1 = timeNow();
+  xc.resize(max(rows, cols), size);
+  vector<decltype(xc.degrees)> degrees(PARTITIONS);
+  vector<K*> pdegrees(PARTITIONS);
+  for (int p=0; p<PARTITIONS; p++) {
+    degrees[p].resize(rows+1);
+    pdegrees[p] = degrees[p].data();
+  }
+  EdgelistBuffer<K, E, O> buf(size, WEIGHTED, T, 16384, huge);
+  a.alloc = duration(t1);
+  // Read MTX body, and convert to CSR.
+  auto t2 = timeNow();
+  readEdgelistFormatToBufferOmpU<WEIGHTED, 1, false, PARTITIONS>(pdegrees.data(), buf, data, false);
+  a.parse = duration(t2);
+  convertEdgelistBufferToCsrOmpW<WEIGHTED, PARTITIONS>(xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), pdegrees.data(), buf, rows, false, &a.convert);
+  a.total = a.header + a.alloc + duration(t2);
+  a.read  = buf.size();
+  a.scratch = buf.bytes();
+  return a;
+}
+
+
+/**
+ * Read a graph with atomic-free vertex-range partitioning, and convert it to CSR.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc output CSR (updated)
+ * @param file input file data (header and body)
+ * @param huge huge page mode of scratch space (HUGE_PAGES_*)
+ * @returns time taken by each phase
+ */
+template <bool WEIGHTED, class G>
+inline Result runReadGraphRanges(G& xc, string_view file, int huge) {
+  using O = size_t;
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  const int T = omp_get_max_threads();
+  Result a;
+  // Read MTX header.
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+  auto t0 = timeNow();
+  size_t head = readMtxFormatHeaderW(symmetric, rows, cols, size, file);
+  string_view data = file.substr(head);
+  a.header = duration(t0);
+  // Allocate space for CSR, and scratch space for edges.
+  // Each thread keeps a partially filled chunk per range, so keep chunks small (below 1/8 of edges).
+  const size_t RANGE = edgelistRangeSize<O>(rows, T);
+  const size_t R     = max((rows + RANGE-1) / RANGE, size_t(1));
+  size_t CHUNK = 256;
+  while (CHUNK < 16384 && 2*CHUNK*T*R*8 <= size) CHUNK *= 2;
+  xc = G();
+  auto t1 = timeNow();
+  xc.resize(max(rows, cols), size);
+  EdgelistBuffer<K, E, O> buf(size, WEIGHTED, T*R, CHUNK, huge);
+  a.alloc = duration(t1);
+  // Read MTX body, and convert to CSR.
+  auto t2 = timeNow();
+  readEdgelistFormatToRangesOmpU<WEIGHTED, 1>(buf, data, false, rows, RANGE);
+  a.parse = duration(t2);
+  convertEdgelistRangesToCsrOmpW<WEIGHTED>(xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), buf, rows, RANGE, &a.convert);
+  a.total = a.header + a.alloc + duration(t2);
+  a.read  = buf.size();
+  a.scratch = buf.bytes();
+  return a;
+}
+
+
+/**
+ * Read a graph with a CSR construction engine, chosen at runtime.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc output CSR (updated)
+ * @param file input file data (header and body)
+ * @param partitions number of partitions for vertex degrees (0 for vertex ranges)
+ * @param huge huge page mode of scratch space (HUGE_PAGES_*)
+ * @returns time taken by each phase
+ */
+template <bool WEIGHTED, class G>
+inline Result runReadGraphWith(G& xc, string_view file, int partitions, int huge) {
+  switch (partitions) {
+    case 0:  return runReadGraphRanges<WEIGHTED>(xc, file, huge);
+    case 1:  return runReadGraph<WEIGHTED, 1>(xc, file, huge);
+    case 2:  return runReadGraph<WEIGHTED, 2>(xc, file, huge);
+    case 4:  return runReadGraph<WEIGHTED, 4>(xc, file, huge);
+    default: return runReadGraph<WEIGHTED, 8>(xc, file, huge);
+  }
+}
+
+
+/**
+ * Read a graph repeatedly (after warmup) with a CSR construction engine, and average the time taken.
+ * @tparam WEIGHTED is graph weighted?
+ * @param y output CSR (updated)
+ * @param xc reference CSR
+ * @param file input file data (header and body)
+ * @param partitions number of partitions for vertex degrees (0 for vertex ranges)
+ * @param huge huge page mode of scratch space (HUGE_PAGES_*)
+ * @param o benchmark options
+ * @param same output same as reference? (output)
+ * @returns time taken by each phase (averaged)
+ */
+template <bool WEIGHTED, class G, class H>
+inline Result runReadGraphRepeat(H& y, const G& xc, string_view file, int partitions, int huge, const Options& o, bool& same) {
+  Result a;
+  for (int r=0; r<o.warmup+o.repeat; ++r) {
+    Result b = runReadGraphWith<WEIGHTED>(y, file, partitions, huge);
+    if (r<o.warmup) continue;
+    a.header += b.header / o.repeat;
+    a.alloc  += b.alloc  / o.repeat;
+    a.parse  += b.parse  / o.repeat;
+    a.total  += b.total  / o.repeat;
+    a.convert.scan    += b.convert.scan    / o.repeat;
+    a.convert.merge   += b.convert.merge   / o.repeat;
+    a.convert.scatter += b.convert.scatter / o.repeat;
+    a.convert.combine += b.convert.combine / o.repeat;
+    a.read = b.read; a.scratch = b.scratch;
+  }
+  same = equalCsrUnordered(y, xc, WEIGHTED);
+  return a;
+}
+
+
+/**
+ * Report the result of a benchmark, in the chosen format.
+ * @param o benchmark options
+ * @param graph graph name
+ * @param technique technique name
+ * @param threads number of threads
+ * @param partitions number of partitions (0 for vertex ranges)
+ * @param storage storage kind (STORAGE_*)
+ * @param order number of vertices
+ * @param bytes input file size
+ * @param a result (averaged over repeats)
+ * @param same result same as reference?
+ */
+inline void reportResult(const Options& o, const string& graph, const string& technique, int threads, int partitions, int storage, size_t order, size_t bytes, const Result& a, bool same) {
+  static const char *STORAGES[] = {"vector", "mapped", "thp", "hugetlb"};
+  const CsrPhaseTimes& c = a.convert;
+  double eps = a.read / (a.total * 1e-3);
+  double bps = bytes  / (a.total * 1e-3);
+  size_t rss = peakResidentSetSize();
+  if (o.format=="json") {
+    printf("{\"graph\":\"%s\",\"technique\":\"%s\",\"threads\":%d,\"partitions\":%d,\"storage\":\"%s\",\"order\":%zu,\"size\":%zu,\"repeat\":%d,", graph.c_str(), technique.c_str(), threads, partitions, STORAGES[storage], order, a.read, o.repeat);
+    printf("\"time\":%.3f,\"header\":%.3f,\"alloc\":%.3f,\"parse\":%.3f,\"scan\":%.3f,\"merge\":%.3f,\"scatter\":%.3f,\"combine\":%.3f,", a.total, a.header, a.alloc, a.parse, c.scan, c.merge, c.scatter, c.combine);
+    printf("\"edgesPerSecond\":%.0f,\"bytesPerSecond\":%.0f,\"scratch\":%zu,\"peakRss\":%zu,\"same\":%s}\n", eps, bps, a.scratch, rss, same? "true" : "false");
+  }
+  else if (o.format=="csv") {
+    printf("%s,%s,%d,%d,%s,%zu,%zu,%d,", graph.c_str(), technique.c_str(), threads, partitions, STORAGES[storage], order, a.read, o.repeat);
+    printf("%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,", a.total, a.header, a.alloc, a.parse, c.scan, c.merge, c.scatter, c.combine);
+    printf("%.0f,%.0f,%zu,%zu,%d\n", eps, bps, a.scratch, rss, same);
+  }
+  else {
+    printf("{%09.1fms, order=%zu, size=%zu, header=%.1fms, alloc=%.1fms, parse=%.1fms, scan=%.1fms, merge=%.1fms, scatter=%.1fms, combine=%.1fms, ", a.total, order, a.read, a.header, a.alloc, a.parse, c.scan, c.merge, c.scatter, c.combine);
+    printf("rate=%.3fGE/s, input=%.3fGB/s, scratch=%zu, rss=%.1fMB, same=%d} %s\n", eps * 1e-9, bps * 1e-9, a.scratch, rss / 1048576.0, same, technique.c_str());
+  }
+}
+
+
+/**
+ * Read a graph with each CSR construction engine, sweeping thread counts, storage kinds, and partition counts.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc reference CSR, from a single-partition engine (output)
+ * @param file input file data (header and body)
+ * @param graph graph name
+ * @param o benchmark options
+ */
+template <bool WEIGHTED, class G>
+inline void runReadGraphSweep(G& xc, string_view file, const string& graph, const Options& o) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  static const char *SUFFIXES[] = {"", "Mapped", "Thp", "Hugetlb"};
+  runReadGraph<WEIGHTED, 1>(xc, file, HUGE_PAGES_NONE);
+  if (o.format=="csv") printf("graph,technique,threads,partitions,storage,order,size,repeat,time,header,alloc,parse,scan,merge,scatter,combine,edgesPerSecond,bytesPerSecond,scratch,peakRss,same\n");
+  for (int T : o.threads) {
+    omp_set_num_threads(T);
+    if (o.format=="text") printf("OMP_NUM_THREADS=%d\n", T);
+    for (int S : o.storages) {
+      for (int P : o.partitions) {
+        Result a; bool same = false;
+        resetPeakResidentSetSize();  // Measure peak memory of this configuration only
+        switch (S) {
+          case STORAGE_VECTOR:  { DiGraphCsr<K, None, E> y; a = runReadGraphRepeat<WEIGHTED>(y, xc, file, P, HUGE_PAGES_NONE, o, same); } break;
+          case STORAGE_MAPPED:  { DiGraphCsr<K, None, E, size_t, MappedVectorNone> y;        a = runReadGraphRepeat<WEIGHTED>(y, xc, file, P, HUGE_PAGES_NONE, o, same); } break;
+          case STORAGE_THP:     { DiGraphCsr<K, None, E, size_t, MappedVectorTransparent> y; a = runReadGraphRepeat<WEIGHTED>(y, xc, file, P, HUGE_PAGES_TRANSPARENT, o, same); } break;
+          case STORAGE_HUGETLB: { DiGraphCsr<K, None, E, size_t, MappedVectorExplicit> y;    a = runReadGraphRepeat<WEIGHTED>(y, xc, file, P, HUGE_PAGES_EXPLICIT, o, same); } break;
+        }
+        string technique = (P? "readGraphOmpPartitions" + to_string(P) : string("readGraphOmpRanges")) + SUFFIXES[S];
+        reportResult(o, graph, technique, T, P, S, xc.order(), file.size(), a, same);
+      }
+    }
+  }
+}
+
+
+/**
+ * Canonicalize a CSR: sort edges, remove duplicate edges (summing weights) and self-loops.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc input CSR
+ * @returns canonicalized CSR
+ */
+template <bool WEIGHTED, class G>
+inline G runCanonicalize(const G& xc) {
+  const size_t N = xc.order();
+  const size_t M = xc.offsets[N];
+  G y = xc;
+  size_t m = 0;
+  float t = measureDuration([&]() {
+    m = canonicalizeCsrOmpW<WEIGHTED>(y.offsets.data(), y.edgeKeys.data(), y.edgeValues.data(), y.degrees.data(), N);
+  });
+  y.edgeKeys.resize(m);
+  y.edgeValues.resize(m);
+  y.sorted = true;
+  // Check that edges are sorted, unique, and present in input.
+  bool valid = true;
+  #pragma omp parallel for schedule(dynamic, 2048) reduction(&&:valid)
+  for (size_t u=0; u<N; ++u) {
+    size_t i = y.offsets[u], I = y.offsets[u+1];
+    valid = valid && I-i==y.degrees[u];
+    for (size_t k=i; k<I; ++k) {
+      valid = valid && y.edgeKeys[k]!=u && (k==i || y.edgeKeys[k-1] < y.edgeKeys[k]);
+      valid = valid && find(xc.edgeKeys.begin()+xc.offsets[u], xc.edgeKeys.begin()+xc.offsets[u+1], y.edgeKeys[k])!=xc.edgeKeys.begin()+xc.offsets[u+1];
+      valid = valid && y.hasEdge(u, y.edgeKeys[k]);
+    }
+  }
+  printf("{%09.1fms, order=%zu, size=%zu, removed=%zu, valid=%d} canonicalizeCsrOmp\n", t, N, m, M-m, valid);
+  return y;
+}
+
+
+/**
+ * Compress a sorted CSR, and compare its size and traversal throughput with the plain CSR.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc input CSR (sorted)
+ */
+template <bool WEIGHTED, class G>
+inline void runCompress(const G& xc) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  const size_t N = xc.order();
+  const size_t M = xc.offsets[N];
+  DiGraphCsrCompressed<K, None, E> xz;
+  float t = measureDuration([&]() {
+    compressCsrOmpW<WEIGHTED>(xz, xc);
+  });
+  // Check that all edges are decoded correctly.
+  bool same = xz.order()==N && xz.size()==M;
+  #pragma omp parallel for schedule(dynamic, 2048) reduction(&&:same)
+  for (size_t u=0; u<N; ++u) {
+    size_t i = xc.offsets[u];
+    xz.forEachEdge(K(u), [&](auto v, auto w) {
+      same = same && v==xc.edgeKeys[i] && (!WEIGHTED || w==xc.edgeValues[i]);
+      ++i;
+    });
+    same = same && i==xc.offsets[u+1];
+  }
+  // Count offsets per vertex in the size of both (and data offsets for compressed).
+  double bpc = double(M * sizeof(K) + (N+1) * sizeof(xc.offsets[0])) / max(M, size_t(1));
+  double bpe = double(xz.edgeData.size() + (N+1) * (sizeof(xz.offsets[0]) + sizeof(xz.dataOffsets[0]))) / max(M, size_t(1));
+  printf("{%09.1fms, order=%zu, size=%zu, bytesPerEdge=%.3f, same=%d} compressCsrOmp\n", t, N, M, bpe, same);
+  // Measure traversal throughput.
+  auto ft = [&](const auto& x, double bytes, const char *name) {
+    uint64_t h = 0;
+    float t = measureDuration([&]() {
+      h = 0;
+      #pragma omp parallel for schedule(dynamic, 2048) reduction(+:h)
+      for (size_t u=0; u<N; ++u)
+        x.forEachEdgeKey(K(u), [&](auto v) { h += v ^ u; });
+    }, 5);
+    double rate = M / (t * 1e6);
+    printf("{%09.1fms, order=%zu, size=%zu, rate=%.3fGE/s, bytesPerEdge=%.3f, hash=%016llx} %s\n", t, N, M, rate, bytes, (unsigned long long) h, name);
+  };
+  ft(xc, bpc, "traverseCsrOmp");
+  ft(xz, bpe, "traverseCsrCompressedOmp");
+}
+
+
+/**
+ * Read a graph from a stream (file, pipe, or stdin) in chunks, and convert it to CSR.
+ * @tparam WEIGHTED is graph weighted?
+ * @param file input file path ("-" for stdin)
+ * @param xr reference CSR to compare with (optional)
+ */
+template <bool WEIGHTED, class G>
+inline void runReadStream(const char *file, const G *xr) {
+  using O = size_t;
+  using K = KEY_TYPE;
+  using E = EDGE_VALUE_TYPE;
+  const int T = omp_get_max_threads();
+  int fd = strcmp(file, "-")==0? 0 : open(file, O_RDONLY);
+  if (fd<0) { printf("Failed to open %s\n", file); return; }
+  DiGraphCsr<K, None, E> xc;
+  vector<K*> degrees(NUM_PARTITIONS);
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0, read = 0;
+  float tr = 0, tp = 0;
+  float t = measureDuration([&]() {
+    // Read MTX header from the first chunk.
+    StreamedFile sf(fd);
+    size_t head = readMtxFormatHeaderW(symmetric, rows, cols, size, sf.data());
+    sf.skip(head);
+    // Allocate space for CSR, per-partition degrees, and bounded scratch space for edges.
+    const size_t N = max(rows, cols);
+    const size_t M = size;
+    xc.resize(N, M);
+    for (int p=0; p<NUM_PARTITIONS; p++)
+      degrees[p] = new K[rows+1]();
+    EdgelistBuffer<K, E, O> buf(size, WEIGHTED, T);
+    // Read MTX body, while parsing.
+    symmetric = false;  // We don't want the reverse edges
+    readEdgelistFormatStreamToBufferOmpU<WEIGHTED, 1, false, NUM_PARTITIONS>(degrees.data(), buf, sf, symmetric);
+    convertEdgelistBufferToCsrOmpW<WEIGHTED, NUM_PARTITIONS>(xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), degrees.data(), buf, rows);
+    read = buf.size();
+    tr = sf.readTime;
+    tp = sf.parseTime;
+  });
+  if (fd!=0) close(fd);
+  for (int p=0; p<NUM_PARTITIONS; p++)
+    delete[] degrees[p];
+  bool same = xr? equalCsrUnordered(xc, *xr, WEIGHTED) : true;
+  printf("{%09.1fms, order=%zu, size=%zu, read=%zu, io=%.1fms, parse=%.1fms, same=%d} readGraphStreamOmp\n", t, rows, size, read, tr, tp, same);
+}
+
+
+/**
+ * Read a symmetric graph with reverse edges, into lists sequentially (reference) and into a bounded scratch buffer, and compare.
+ * @tparam WEIGHTED is graph weighted?
+ * @param file input file data (header and body)
+ * @returns reference CSR, with reverse edges
+ */
+template <bool WEIGHTED>
+inline auto runReadSymmetric(string_view file) {
+  using O = size_t;
+  using K = KEY_TYPE;
+  using E = EDGE_VALUE_TYPE;
+  const int T = omp_get_max_threads();
+  bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
+  size_t head = readMtxFormatHeaderW(symmetric, rows, cols, size, file);
+  string_view data = file.substr(head);
+  const size_t N = max(rows, cols);
+  // Read into lists sequentially, with the reverse edges stored (reference).
+  DiGraphCsr<K, None, E> xr;
+  xr.resize(N, 2*size);
+  {
+    vector<K> degrees(N+1), sources(2*size), targets(2*size);
+    vector<E> weights(WEIGHTED? 2*size : 0);
+    readEdgelistFormatToListsU<WEIGHTED, 1, false>(degrees.data(), sources.data(), targets.data(), weights.data(), data, true);
+    xr.offsets[0] = 0;
+    size_t M = exclusiveScanW(xr.offsets.data()+1, degrees.data(), N);
+    for (size_t i=0; i<M; ++i) {
+      size_t j = xr.offsets[sources[i]+1]++;
+      xr.edgeKeys[j] = targets[i];
+      if constexpr (WEIGHTED) xr.edgeValues[j] = weights[i];
+    }
+  }
+  // Read into a bounded scratch buffer, with the reverse edges only counted (added during conversion).
+  DiGraphCsr<K, None, E> xc;
+  vector<vector<K>> degrees(NUM_PARTITIONS);
+  vector<K*> pdegrees(NUM_PARTITIONS);
+  float t = measureDuration([&]() {
+    xc.resize(N, 2*size);
+    for (int p=0; p<NUM_PARTITIONS; ++p) {
+      degrees[p].assign(rows+1, K());
+      pdegrees[p] = degrees[p].data();
+    }
+    EdgelistBuffer<K, E, O> buf(size, WEIGHTED, T);
+    readEdgelistFormatToBufferOmpU<WEIGHTED, 1, false, NUM_PARTITIONS>(pdegrees.data(), buf, data, true);
+    convertEdgelistBufferToCsrOmpW<WEIGHTED, NUM_PARTITIONS>(xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), pdegrees.data(), buf, rows, true);
+  });
+  bool same = equalCsrUnordered(xc, xr, WEIGHTED);
+  printf("{%09.1fms, order=%zu, size=%zu, same=%d} readGraphOmpSymmetric\n", t, N, size_t(xc.offsets[N]), same);
+  return xr;
+}
+
+
+/**
+ * Read a graph with sparse (64-bit) vertex ids, relabeling them to dense ids, and convert it to CSR (without, and with format checks).
+ * @tparam WEIGHTED is graph weighted?
+ * @param data input file data (with MTX header, or headerless)
+ * @param xr reference CSR with 1-based original ids, to compare with (optional)
+ */
+template <bool WEIGHTED, class G>
+inline void runReadSparse(string_view data, const G *xr) {
+  using K = KEY_TYPE;
+  using E = EDGE_VALUE_TYPE;
+  for (int check=0; check<2; ++check) {
+    DiGraphCsr<K, None, E> y;
+    vector<uint64_t> ids;
+    CsrPhaseTimes c;
+    float t = 0;
+    try {
+      t = measureDuration([&]() {
+        if (check) ids = readSparseEdgelistFormatOmpW<WEIGHTED, true,  NUM_PARTITIONS>(y, data, &c);
+        else       ids = readSparseEdgelistFormatOmpW<WEIGHTED, false, NUM_PARTITIONS>(y, data, &c);
+      });
+    }
+    catch (const FormatError& e) {
+      printf("{error=\"%s\"} %s\n", e.what(), check? "readSparseGraphOmpChecked" : "readSparseGraphOmp");
+      continue;
+    }
+    const size_t N = y.order();
+    const size_t M = y.offsets[N];
+    // Check that original ids are ascending, and that edges map back to the reference.
+    bool valid = true;
+    for (size_t i=1; i<N; ++i)
+      valid = valid && ids[i-1] < ids[i];
+    bool same = valid;
+    if (xr) {
+      same = same && M==xr->offsets[xr->order()];
+      #pragma omp parallel for schedule(dynamic, 2048) reduction(&&:same)
+      for (size_t u=0; u<N; ++u) {
+        size_t U = ids[u]-1;
+        if (ids[u]==0 || U>=xr->order()) { same = false; continue; }
+        vector<pair<uint64_t, E>> ex, ey;
+        for (size_t i=xr->offsets[U]; i<xr->offsets[U+1]; ++i)
+          ex.push_back({xr->edgeKeys[i]+1, WEIGHTED? xr->edgeValues[i] : E()});
+        for (size_t i=y.offsets[u]; i<y.offsets[u+1]; ++i)
+          ey.push_back({ids[y.edgeKeys[i]], WEIGHTED? y.edgeValues[i] : E()});
+        sort(ex.begin(), ex.end());
+        sort(ey.begin(), ey.end());
+        same = same && ex==ey;
+      }
+    }
+    printf("{%09.1fms, order=%zu, size=%zu, parse=%.1fms, relabel=%.1fms, scan=%.1fms, merge=%.1fms, scatter=%.1fms, combine=%.1fms, ", t, N, M, c.parse, c.relabel, c.scan, c.merge, c.scatter, c.combine);
+    printf("maxId=%llu, same=%d} %s\n", N? (unsigned long long) ids[N-1] : 0ULL, same, check? "readSparseGraphOmpChecked" : "readSparseGraphOmp");
+  }
+}
+
+
+/**
+ * Convert a CSR to a snapshot file, and compare its load time with text load.
+ * @tparam WEIGHTED is graph weighted?
+ * @param xc input CSR
+ * @param snapshot snapshot file path
+ * @param out stream to report on (stderr keeps csv/json output clean)
+ */
+template <bool WEIGHTED, class G>
+inline void runSnapshot(const G& xc, const char *snapshot, FILE *out=stdout) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  const size_t N = xc.order();
+  const size_t M = xc.offsets[N];
+  bool done = false;
+  float tw = measureDuration([&]() {
+    done = writeCsrSnapshotOmp<WEIGHTED>(snapshot, xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), N, M, xc.sorted);
+  });
+  fprintf(out, "{%09.1fms, order=%zu, size=%zu, done=%d} writeCsrSnapshotOmp\n", tw, N, M, done);
+  for (int check=0; check<2; ++check) {
+    unique_ptr<MappedFile> sf;
+    DiGraphCsrView<K, None, E> xs;
+    float tr = measureDuration([&]() {
+      sf = make_unique<MappedFile>(snapshot);
+      string_view sdata((const char*) sf->data(), sf->size());
+      if (check) readCsrSnapshotW<true> (xs, sdata);
+      else       readCsrSnapshotW<false>(xs, sdata);
+    });
+    bool same = xs.order()==N && xs.size()==M && xs.sorted==xc.sorted;
+    same = same && equal(xs.offsets,  xs.offsets+N+1, xc.offsets.data());
+    same = same && equal(xs.edgeKeys, xs.edgeKeys+M,  xc.edgeKeys.data());
+    if (WEIGHTED) same = same && equal(xs.edgeValues, xs.edgeValues+M, xc.edgeValues.data());
+    fprintf(out, "{%09.1fms, order=%zu, size=%zu, same=%d} %s\n", tr, xs.order(), xs.size(), same, check? "readCsrSnapshotChecked" : "readCsrSnapshot");
+  }
+}
+
+
+/**
+ * Generate a synthetic graph, and write it as an MTX file (or Edgelist file, if not *.mtx, or if sparse).
+ * @param o benchmark options
+ * @returns success?
+ */
+inline bool runGenerate(const Options& o) {
+  const size_t N = o.vertices, M = o.edges;
+  const uint64_t S = o.seed;
+  const double A = o.skew[0], B = o.skew[1], C = o.skew[2];
+  string_view pth(o.file);
+  bool mtx  = !o.sparse && pth.size()>=4 && pth.substr(pth.size()-4)==".mtx";
+  bool rmat = o.generate=="rmat";
+  bool done = false;
+  // Scatter vertex ids over 64 bits, if sparse (one-to-one, as the mixer is a bijection; the writer adds 1).
+  auto fs = [&](auto& u, auto& v) {
+    if (!o.sparse) return;
+    u = randomCounter64(S+1, u) - 1;
+    v = randomCounter64(S+1, v) - 1;
+  };
+  auto fu = [&](auto& u, auto& v, auto& w, size_t i) { generateUniformEdgeW(u, v, w, i, N, S); fs(u, v); };
+  auto fr = [&](auto& u, auto& v, auto& w, size_t i) { generateRmatEdgeW(u, v, w, i, N, A, B, C, S); fs(u, v); };
+  float t = measureDuration([&]() {
+    if (rmat) done = o.weighted? writeGeneratedGraphOmp<true>(o.file, N, M, mtx, fr) : writeGeneratedGraphOmp<false>(o.file, N, M, mtx, fr);
+    else      done = o.weighted? writeGeneratedGraphOmp<true>(o.file, N, M, mtx, fu) : writeGeneratedGraphOmp<false>(o.file, N, M, mtx, fu);
+  });
+  if (o.format=="text") printf("{%09.1fms, order=%zu, size=%zu, done=%d} %s\n", t, N, M, done, rmat? "generateRmatOmp" : "generateUniformOmp");
+  return done;
+}
+
+
+/**
+ * Parse a comma-separated list of numbers (or "ranges", as 0).
+ * @param x list text
+ * @returns list of numbers
+ */
+inline vector<int> parseList(const char *x) {
+  vector<int> a;
+  for (string_view s(x); !s.empty();) {
+    size_t i = s.find(',');
+    string_view t = s.substr(0, i);
+    a.push_back(t=="ranges" || t=="r"? 0 : atoi(string(t).c_str()));
+    s = i==string_view::npos? string_view() : s.substr(i+1);
+  }
+  return a;
+}
+
+
+/**
+ * Parse command line options.
+ * @param o benchmark options (output)
+ * @param argc argument count
+ * @param argv argument values
+ * @returns success?
+ */
+inline bool parseOptions(Options& o, int argc, char **argv) {
+  vector<const char*> args;
+  for (int i=1; i<argc; ++i) {
+    string_view k(argv[i]);
+    bool more = i+1<argc;
+    if      (k=="-t" || k=="--threads")    { if (!more) return false; o.threads    = parseList(argv[++i]); }
+    else if (k=="-p" || k=="--partitions") { if (!more) return false; o.partitions = parseList(argv[++i]); }
+    else if (k=="-S" || k=="--storage") {
+      if (!more) return false;
+      for (string_view t(argv[++i]); !t.empty();) {
+        size_t j = t.find(',');
+        string_view u = t.substr(0, j);
+        if      (u=="vector")  o.storages.push_back(STORAGE_VECTOR);
+        else if (u=="mapped")  o.storages.push_back(STORAGE_MAPPED);
+        else if (u=="thp")     o.storages.push_back(STORAGE_THP);
+        else if (u=="hugetlb") o.storages.push_back(STORAGE_HUGETLB);
+        else return false;
+        t = j==string_view::npos? string_view() : t.substr(j+1);
+      }
+    }
+    else if (k=="-r" || k=="--repeat")     { if (!more) return false; o.repeat = atoi(argv[++i]); }
+    else if (k=="-w" || k=="--warmup")     { if (!more) return false; o.warmup = atoi(argv[++i]); }
+    else if (k=="-f" || k=="--format")     { if (!more) return false; o.format = argv[++i]; }
+    else if (k=="-g" || k=="--generate")   { if (!more) return false; o.generate = argv[++i]; }
+    else if (k=="-n" || k=="--vertices")   { if (!more) return false; o.vertices = strtoull(argv[++i], nullptr, 10); }
+    else if (k=="-m" || k=="--edges")      { if (!more) return false; o.edges    = strtoull(argv[++i], nullptr, 10); }
+    else if (k=="-s" || k=="--seed")       { if (!more) return false; o.seed     = strtoull(argv[++i], nullptr, 10); }
+    else if (k=="--sparse") o.sparse = true;
+    else if (k=="--skew") {
+      if (!more || sscanf(argv[++i], "%lf,%lf,%lf", &o.skew[0], &o.skew[1], &o.skew[2])!=3) return false;
+    }
+    else if (k.size()>1 && k[0]=='-') return false;
+    else args.push_back(argv[i]);
+  }
+  if (args.empty()) return false;
+  o.file     = args[0];
+  o.weighted = args.size()>1? atoi(args[1]) : false;
+  o.snapshot = args.size()>2? args[2] : nullptr;
+  if (o.threads.empty())    o.threads    = {MAX_THREADS};
+  if (o.partitions.empty()) o.partitions = {1, 2, 4, 8, 0};
+  if (o.storages.empty())   o.storages   = {STORAGE_VECTOR, STORAGE_THP};
+  for (int P : o.partitions)
+    if (P!=0 && P!=1 && P!=2 && P!=4 && P!=8) return false;
+  if (!o.generate.empty() && o.generate!="rmat" && o.generate!="uniform") return false;
+  if (o.format!="text" && o.format!="csv" && o.format!="json") return false;
+  o.repeat = max(o.repeat, 1);
+  o.warmup = max(o.warmup, 0);
+  o.vertices = max(o.vertices, size_t(1));
+  return true;
+}
+
+
 /**
  * Main function.
  * @param argc argument count
@@ -42,59 +776,90 @@ using namespace std;
  * @returns zero on success, non-zero on failure
  */
 int main(int argc, char **argv) {
-  using O = size_t;
   using K = KEY_TYPE;
   using E = EDGE_VALUE_TYPE;
-  char *file    = argv[1];
-  bool weighted = argc>2? atoi(argv[2]) : false;
-  omp_set_num_threads(MAX_THREADS);
-  printf("OMP_NUM_THREADS=%d\n", MAX_THREADS);
-  printf("NUM_PARTITIONS=%d\n", NUM_PARTITIONS);
-  printf("Reading graph %s ...\n", file);
-  // Read MTX file header.
+  Options o;
+  if (!parseOptions(o, argc, argv)) {
+    fprintf(stderr, "Usage: %s [options] <file> [weighted] [snapshot]\n", argv[0]);
+    fprintf(stderr, "  -t, --threads LIST       thread counts to sweep (default: %d)\n", MAX_THREADS);
+    fprintf(stderr, "  -p, --partitions LIST    partition counts (1,2,4,8) or \"ranges\" to sweep (default: 1,2,4,8,ranges)\n");
+    fprintf(stderr, "  -S, --storage LIST       CSR/scratch storage to sweep: vector, mapped, thp, hugetlb (default: vector,thp)\n");
+    fprintf(stderr, "  -r, --repeat N           measured runs per configuration (default: 5)\n");
+    fprintf(stderr, "  -w, --warmup N           warmup runs per configuration (default: 1)\n");
+    fprintf(stderr, "  -f, --format FORMAT      output format: text, csv, or json (default: text)\n");
+    fprintf(stderr, "  -g, --generate KIND      generate graph into <file> first: rmat, or uniform\n");
+    fprintf(stderr, "  -n, --vertices N         vertices to generate (default: 2^20)\n");
+    fprintf(stderr, "  -m, --edges M            edges to generate (default: 2^24)\n");
+    fprintf(stderr, "      --skew A,B,C         R-MAT quadrant probabilities (default: 0.57,0.19,0.19)\n");
+    fprintf(stderr, "      --sparse             read only with sparse 64-bit ids (headerless Edgelist allowed), or generate such ids\n");
+    fprintf(stderr, "  -s, --seed S             random seed (default: 42)\n");
+    return 1;
+  }
+  const char *file = o.file;
+  bool weighted = o.weighted;
+  int  threads  = *max_element(o.threads.begin(), o.threads.end());
+  omp_set_num_threads(threads);
+  // Generate graph, if asked.
+  if (!o.generate.empty()) {
+    if (!runGenerate(o)) { fprintf(stderr, "Failed to generate graph %s\n", file); return 1; }
+    string_view pth(file);
+    if (!o.sparse && (pth.size()<4 || pth.substr(pth.size()-4)!=".mtx")) return 0;
+  }
+  if (o.format=="text") {
+    printf("OMP_NUM_THREADS=%d\n", threads);
+    printf("NUM_PARTITIONS=%d\n", NUM_PARTITIONS);
+    printf("Reading graph %s ...\n", file);
+  }
+  // Read from a pipe or stdin, if the file cannot be mapped.
   MappedFile mf(file);
+  if (!mf.data()) {
+    if (weighted) runReadStream<true> (file, (DiGraphCsr<K, None, E>*) nullptr);
+    else          runReadStream<false>(file, (DiGraphCsr<K, None, E>*) nullptr);
+    printf("\n");
+    return 0;
+  }
   string_view data((const char*) mf.data(), mf.size());
+  string_view name(file);
+  name = name.substr(name.rfind('/')==string_view::npos? 0 : name.rfind('/')+1);
+  name = name.substr(0, name.rfind('.'));
+  // Read graph with sparse vertex ids only, if asked (the file need not have a header).
+  if (o.sparse) {
+    if (weighted) runReadSparse<true> (data, (DiGraphCsr<K, None, E>*) nullptr);
+    else          runReadSparse<false>(data, (DiGraphCsr<K, None, E>*) nullptr);
+    printf("\n");
+    return 0;
+  }
+  // Read graph with each CSR construction engine, sweeping thread and partition counts.
+  DiGraphCsr<K, None, E> xc;
+  if (weighted) runReadGraphSweep<true> (xc, data, string(name), o);
+  else          runReadGraphSweep<false>(xc, data, string(name), o);
+  // Convert to CSR snapshot, and compare its load time with text load.
+  if (o.snapshot) {
+    FILE *out = o.format=="text"? stdout : stderr;
+    if (weighted) runSnapshot<true> (xc, o.snapshot, out);
+    else          runSnapshot<false>(xc, o.snapshot, out);
+  }
+  // Remaining benchmarks report only in text format.
+  if (o.format!="text") return 0;
+  omp_set_num_threads(threads);
+  // Measure single-core parsing throughput.
   bool symmetric = false; size_t rows = 0, cols = 0, size = 0;
   size_t head = readMtxFormatHeaderW(symmetric, rows, cols, size, data);
-  data.remove_prefix(head);
-  // Allocate space for CSR.
-  DiGraphCsr<K, None, E> xc;
-  const size_t N = max(rows, cols);
-  const size_t M = size;
-  xc.resize(N, M);
-  // Allocate space for sources, targets, weights, degrees, offsets, edge keys, and edge values.
-  const int T = omp_get_max_threads();
-  vector<size_t> counts;
-  vector<K*> degrees(T);
-  vector<K*> sources(T);
-  vector<K*> targets(T);
-  vector<E*> weights(T);
-  vector<O*> poffsets(NUM_PARTITIONS);
-  vector<K*> pedgeKeys(NUM_PARTITIONS);
-  vector<E*> pedgeValues(NUM_PARTITIONS);
-  for (int t=0; t<T; t++) {
-    sources[t] = new K[size];
-    targets[t] = new K[size];
-    weights[t] = weighted? new E[size] : nullptr;
-  }
-  for (int p=0; p<NUM_PARTITIONS; p++) {
-    degrees[p]     = new K[rows+1];
-    poffsets[p]    = new O[rows+1];
-    pedgeKeys[p]   = new K[size];
-    pedgeValues[p] = weighted? new E[size] : nullptr;
-  }
-  // Read MTX file body.
-  symmetric = false;  // We don't want the reverse edges
-  float t = measureDuration([&]() {
-    if (weighted) counts = readEdgelistFormatToListsOmpU<true,  1, false, NUM_PARTITIONS>(degrees.data(), sources.data(), targets.data(), weights.data(), data, symmetric);
-    else          counts = readEdgelistFormatToListsOmpU<false, 1, false, NUM_PARTITIONS>(degrees.data(), sources.data(), targets.data(), weights.data(), data, symmetric);
-    convertEdgelistToCsrListsOmpW<false, NUM_PARTITIONS>(xc.offsets.data(), xc.edgeKeys.data(), xc.edgeValues.data(), poffsets.data(), pedgeKeys.data(), pedgeValues.data(), degrees.data(), sources.data(), targets.data(), weights.data(), counts, rows);
-  });
-  // Calculate total number of edges read.
-  size_t read = 0;
-  for (int t=0; t<MAX_THREADS; t++)
-    read += counts[t];
-  printf("{%09.1fms, order=%zu, size=%zu, read=%zu} readGraphOmp\n", t, rows, size, read);
+  if (weighted) runParseEdgelist<true> (data.substr(head), rows, size);
+  else          runParseEdgelist<false>(data.substr(head), rows, size);
+  // Sort edges, and remove duplicates and self-loops.
+  // Compress sorted CSR, and compare with plain CSR.
+  if (weighted) runCompress<true> (runCanonicalize<true> (xc));
+  else          runCompress<false>(runCanonicalize<false>(xc));
+  // Read the same file in chunks, and compare with memory-mapped read.
+  if (weighted) runReadStream<true> (file, &xc);
+  else          runReadStream<false>(file, &xc);
+  // Read a symmetric file with reverse edges, and compare the scratch buffer loader with the list loader.
+  DiGraphCsr<K, None, E> xs;
+  if (symmetric) xs = weighted? runReadSymmetric<true>(data) : runReadSymmetric<false>(data);
+  // Read the same file as sparse vertex ids, and compare after mapping back to original ids (with reverse edges, if symmetric).
+  if (weighted) runReadSparse<true> (data, symmetric? &xs : &xc);
+  else          runReadSparse<false>(data, symmetric? &xs : &xc);
   printf("\n");
   return 0;
 }
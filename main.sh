@@ -26,6 +26,13 @@ cd $src
 : "${EDGE_VALUE_TYPE:=float}"
 : "${MAX_THREADS:=64}"
 : "${NUM_PARTITIONS:=4}"
+# Benchmark options (thread/partition sweeps, repeats, output format)
+: "${THREADS:=1,2,4,8,16,32,64}"
+: "${PARTITIONS:=1,2,4,8,ranges}"
+: "${STORAGE:=vector,thp}"
+: "${REPEAT:=5}"
+: "${FORMAT:=text}"
+OPTIONS="--threads $THREADS --partitions $PARTITIONS --storage $STORAGE --repeat $REPEAT --format $FORMAT"
 # Define macros (dont forget to add here)
 DEFINES=(""
 "-DKEY_TYPE=$KEY_TYPE"
@@ -37,28 +44,39 @@ DEFINES=(""
 # Compile
 g++ ${DEFINES[*]} -std=c++17 -O3 -fopenmp main.cxx  # -Wall -Wno-unknown-pragmas
 
+# Run on generated graphs, when datasets are not available (offline)
+runGenerated() {
+stdbuf --output=L ./a.out $OPTIONS --generate rmat    -n 16777216 -m 268435456 /tmp/rmat-24.mtx    2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS --generate uniform -n 16777216 -m 268435456 /tmp/uniform-24.mtx 2>&1 | tee -a "$out"
+rm -f /tmp/rmat-24.mtx /tmp/uniform-24.mtx
+}
+
 # Perform necessary steps
 runEach() {
-# stdbuf --output=L ./a.out ~/Data/soc-Epinions1.mtx   2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/indochina-2004.mtx  2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/uk-2002.mtx         2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/arabic-2005.mtx     2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/uk-2005.mtx         2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/webbase-2001.mtx    2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/it-2004.mtx         2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/sk-2005.mtx         2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/com-LiveJournal.mtx 2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/com-Orkut.mtx       2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/asia_osm.mtx        2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/europe_osm.mtx      2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/kmer_A2a.mtx        2>&1 | tee -a "$out"
-stdbuf --output=L ./a.out ~/Data/kmer_V1r.mtx        2>&1 | tee -a "$out"
+if [[ "$GENERATE" == "1" ]]; then
+  runGenerated
+  return
+fi
+# stdbuf --output=L ./a.out $OPTIONS ~/Data/soc-Epinions1.mtx   2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/indochina-2004.mtx  2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/uk-2002.mtx         2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/arabic-2005.mtx     2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/uk-2005.mtx         2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/webbase-2001.mtx    2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/it-2004.mtx         2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/sk-2005.mtx         2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/com-LiveJournal.mtx 2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/com-Orkut.mtx       2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/asia_osm.mtx        2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/europe_osm.mtx      2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/kmer_A2a.mtx        2>&1 | tee -a "$out"
+stdbuf --output=L ./a.out $OPTIONS ~/Data/kmer_V1r.mtx        2>&1 | tee -a "$out"
 }
 
-# Run 5 times
-for i in {1..5}; do
-  runEach
-done
+# Run once (repeats are done by the program)
+runEach
 
 # Signal completion
+if [[ "$IFTTT_KEY" != "" ]]; then
 curl -X POST "https://maker.ifttt.com/trigger/puzzlef/with/key/${IFTTT_KEY}?value1=$src$1"
+fi
@@ -4,7 +4,8 @@ const path = require('path');
 
 const ROMPTH = /^OMP_NUM_THREADS=(.+)/m;
 const RGRAPH = /^Reading graph .*\/(.*?)\.mtx \.\.\./m;
-const RRESLT = /^\{(.+?)ms, order=(.+?), size=(.+?)\} (.+)/m;
+const RRESLT = /^\{(.+?)ms, order=(.+?), size=(.+?)(?:, (.+?))?\} (.+)/m;
+const RJSONL = /^\{".*\}$/m;
 
 
 
@@ -29,10 +30,10 @@ function writeFile(pth, d) {
 // -----
 
 function writeCsv(pth, rows) {
-  var cols = Object.keys(rows[0]);
+  var cols = [...new Set(rows.flatMap(r => Object.keys(r)))];
   var a = cols.join()+'\n';
   for (var r of rows)
-    a += [...Object.values(r)].map(v => `"${v}"`).join()+'\n';
+    a += cols.map(c => `"${r[c]!=null? r[c] : ''}"`).join()+'\n';
   writeFile(pth, a);
 }
 
@@ -54,18 +55,34 @@ function readLogLine(ln, data, state) {
     if (!data.has(graph)) data.set(graph, []);
     state.graph = graph;
   }
+  else if (RJSONL.test(ln)) {
+    var row = JSON.parse(ln);
+    if (!data.has(row.graph)) data.set(row.graph, []);
+    data.get(row.graph).push(row);
+  }
   else if (RRESLT.test(ln)) {
-    var [, time, order, size, technique] = RRESLT.exec(ln);
+    var [, time, order, size, extra, technique] = RRESLT.exec(ln);
     data.get(state.graph).push(Object.assign({}, state, {
       order: parseFloat(order),
       size:  parseFloat(size),
       time:  parseFloat(time),
-      technique,
-    }));
+    }, readLogFields(extra), {technique}));
   }
   return state;
 }
 
+// Read extra "key=value" fields of a result (times in ms, rates, etc.).
+function readLogFields(extra) {
+  var a = {};
+  if (!extra) return a;
+  for (var kv of extra.split(', ')) {
+    var [k, v] = kv.split('=');
+    if (v==null) continue;
+    a[k] = isNaN(parseFloat(v))? v : parseFloat(v);
+  }
+  return a;
+}
+
 function readLog(pth) {
   var text  = readFile(pth);
   var lines = text.split('\n');